@@ -0,0 +1,57 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// wall clock seconds since some fixed point, for timing whole loops
+inline double BenchSeconds() {
+	using namespace std::chrono;
+	return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+// keeps the optimizer from throwing away a result we only compute for timing
+// the value's address escapes into an empty asm block the compiler can't see through
+#if !defined(_MSC_VER)
+template <typename T>
+inline void BenchKeep(const T& value) {
+	asm volatile("" : : "g"(&value) : "memory");
+}
+#else
+// msvc has no inline asm on x64, the address goes out through a volatile pointer instead
+inline const void* volatile benchEscape = nullptr;
+
+template <typename T>
+inline void BenchKeep(const T& value) {
+	benchEscape = &value;
+	_ReadWriteBarrier();
+}
+#endif
+
+// one line of results. every suite records what it measured here as well as printing it,
+// so main can write the whole run out as json for comparing against older runs
+struct BenchResult {
+	std::string suite;
+	std::string name;
+	int count = 0; // bodies or objekts, 0 when it doesn't apply
+	std::vector<std::string> metricNames;
+	std::vector<double> metricValues;
+
+	BenchResult& metric(const char* metricName, double value) {
+		metricNames.push_back(metricName);
+		metricValues.push_back(value);
+		return *this;
+	}
+};
+
+BenchResult& BenchRecord(const char* suite, const std::string& name, int count = 0);
+bool BenchWriteJson(const char* path);
+
+// one suite per file, main() picks them by name
+int RunIntegratorBenchmark(int argc, char** argv);
+int RunNarrowPhaseBenchmark(int argc, char** argv);
+int RunWorldBenchmark(int argc, char** argv);
+int RunScalingBenchmark(int argc, char** argv);
@@ -0,0 +1,94 @@
+#include "bench.h"
+#include "bodies.h"
+#include "integrator.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static void MakeBodies(FizziksBodies& bodies, int count) {
+	bodies.clear();
+	bodies.reserve(count);
+
+	srand(1234);
+	for (int i = 0; i < count; i++) {
+		FizziksBodyState state;
+		state.position = { (float)(rand() % 4000), (float)(rand() % 4000) };
+		state.velocity = { (float)(rand() % 200 - 100), (float)(rand() % 200 - 100) };
+		state.mass = 0.5f + (rand() % 100) / 50.0f;
+		state.isStatic = (i % 16) == 0; // a few static bodies so the masks have work to do
+		bodies.create(state);
+	}
+}
+
+static unsigned long long Checksum(const FizziksBodies& bodies) {
+	unsigned long long sum = 1469598103934665603ull;
+	const std::vector<float>* arrays[] = { &bodies.positionX, &bodies.positionY, &bodies.velocityX, &bodies.velocityY };
+	for (const std::vector<float>* array : arrays) {
+		for (float v : *array) {
+			unsigned int bits;
+			memcpy(&bits, &v, sizeof(bits));
+			sum = (sum ^ bits) * 1099511628211ull;
+		}
+	}
+	return sum;
+}
+
+int RunIntegratorBenchmark(int argc, char** argv) {
+	const int counts[] = { 10000, 100000, 1000000 };
+	const float dt = 1.0f / 50;
+	const Vector2 gravity = { 0, 50 };
+
+	FizziksSimdLevel best = FizziksBestSimdLevel();
+	printf("integrator benchmark, best simd level on this machine: %s\n\n", FizziksSimdLevelName(best));
+	printf("%10s  %-7s %16s %16s %16s\n", "bodies", "path", "gravity b/s", "integrate b/s", "step b/s");
+
+	int result = 0;
+	FizziksBodies bodies;
+
+	for (int count : counts) {
+		// roughly the same amount of work at every size
+		int steps = std::max(10, 50000000 / count);
+		unsigned long long scalarChecksum = 0;
+
+		for (int level = SIMD_SCALAR; level <= best; level++) {
+			MakeBodies(bodies, count);
+
+			double gravitySeconds = 0;
+			double integrateSeconds = 0;
+
+			for (int step = 0; step < steps; step++) {
+				std::fill(bodies.forceX.begin(), bodies.forceX.end(), 0.0f);
+				std::fill(bodies.forceY.begin(), bodies.forceY.end(), 0.0f);
+
+				double start = BenchSeconds();
+				FizziksAddGravity(bodies, gravity, (FizziksSimdLevel)level);
+				double middle = BenchSeconds();
+				FizziksIntegrate(bodies, dt, (FizziksSimdLevel)level);
+				double end = BenchSeconds();
+
+				gravitySeconds += middle - start;
+				integrateSeconds += end - middle;
+			}
+
+			double bodySteps = (double)count * steps;
+			printf("%10d  %-7s %16.3e %16.3e %16.3e\n", count, FizziksSimdLevelName((FizziksSimdLevel)level),
+				bodySteps / gravitySeconds, bodySteps / integrateSeconds, bodySteps / (gravitySeconds + integrateSeconds));
+			BenchRecord("integrator", FizziksSimdLevelName((FizziksSimdLevel)level), count)
+				.metric("gravity_bodies_per_sec", bodySteps / gravitySeconds)
+				.metric("integrate_bodies_per_sec", bodySteps / integrateSeconds)
+				.metric("step_bodies_per_sec", bodySteps / (gravitySeconds + integrateSeconds));
+
+			// every path has to land on exactly the same bits
+			unsigned long long checksum = Checksum(bodies);
+			if (level == SIMD_SCALAR) scalarChecksum = checksum;
+			else if (checksum != scalarChecksum) {
+				printf("            %s result differs from scalar!\n", FizziksSimdLevelName((FizziksSimdLevel)level));
+				result = 1;
+			}
+			BenchKeep(checksum);
+		}
+	}
+
+	return result;
+}
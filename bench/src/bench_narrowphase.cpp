@@ -0,0 +1,202 @@
+#include "bench.h"
+#include "fizziks.h"
+#include "scenes.h"
+#include <cstdio>
+
+// every call resolves the overlap it finds, so each batch works on fresh copies of the
+// same pairs: the body arrays get put back between batches, outside the timed part
+static const int pairsPerBatch = 1024;
+static const int batches = 2000;
+
+struct NarrowPhaseFunction {
+	const char* name;
+	// builds one pair whose surfaces are gap apart (negative overlaps)
+	void (*make)(FizziksWorld& world, float gap, unsigned int& seed, FizziksObjekt** a, FizziksObjekt** b);
+	bool (*call)(FizziksObjekt* a, FizziksObjekt* b, FizziksWorld& world);
+};
+
+struct NarrowPhaseConfig {
+	const char* name;
+	float gap;
+};
+
+static float BenchRandom(unsigned int& state) {
+	state = state * 1664525u + 1013904223u;
+	return (state >> 8) * (1.0f / 16777216.0f);
+}
+
+// pairs are spread out so nothing else would ever touch them
+static Vector2 PairOrigin(FizziksWorld& world) {
+	float slot = (float)world.objekts.size();
+	return { fmodf(slot * 100, 10000), floorf(slot / 100) * 100 };
+}
+
+static Vector2 RandomDirection(unsigned int& seed) {
+	return Vector2Rotate({ 1, 0 }, BenchRandom(seed) * 2 * PI);
+}
+
+static FizziksHalfspace* MakeHalfspace(FizziksWorld& world, Vector2 position, unsigned int& seed) {
+	FizziksHalfspace* halfspace = world.createHalfspace();
+	halfspace->setStatic(true);
+	halfspace->setRotationDegrees((BenchRandom(seed) - 0.5f) * 60);
+	halfspace->setPosition(position);
+	return halfspace;
+}
+
+static FizziksCircle* MakeCircle(FizziksWorld& world, Vector2 position, unsigned int& seed) {
+	FizziksCircle* circle = world.createCircle();
+	circle->radius = 5 + BenchRandom(seed) * 10;
+	circle->setPosition(position);
+	circle->setVelocity({ (BenchRandom(seed) - 0.5f) * 100, (BenchRandom(seed) - 0.5f) * 100 });
+	return circle;
+}
+
+static FizziksAABB* MakeAABB(FizziksWorld& world, Vector2 position, unsigned int& seed) {
+	FizziksAABB* aabb = world.createAABB();
+	aabb->sizeXY = { 10 + BenchRandom(seed) * 20, 10 + BenchRandom(seed) * 20 };
+	aabb->setPosition(position);
+	aabb->setVelocity({ (BenchRandom(seed) - 0.5f) * 100, (BenchRandom(seed) - 0.5f) * 100 });
+	return aabb;
+}
+
+static void MakeCircleCircle(FizziksWorld& world, float gap, unsigned int& seed, FizziksObjekt** a, FizziksObjekt** b) {
+	Vector2 origin = PairOrigin(world);
+	FizziksCircle* circleA = MakeCircle(world, origin, seed);
+	FizziksCircle* circleB = MakeCircle(world, origin, seed);
+	circleB->setPosition(origin + RandomDirection(seed) * (circleA->radius + circleB->radius + gap));
+	*a = circleA;
+	*b = circleB;
+}
+
+static void MakeCircleHalfspace(FizziksWorld& world, float gap, unsigned int& seed, FizziksObjekt** a, FizziksObjekt** b) {
+	Vector2 origin = PairOrigin(world);
+	FizziksHalfspace* halfspace = MakeHalfspace(world, origin, seed);
+	FizziksCircle* circle = MakeCircle(world, origin, seed);
+	circle->setPosition(origin + halfspace->getNormal() * (circle->radius + gap));
+	*a = circle;
+	*b = halfspace;
+}
+
+// b sits to the right of a with their vertical extents overlapping, so the gap is along x
+static void MakeAABBAABB(FizziksWorld& world, float gap, unsigned int& seed, FizziksObjekt** a, FizziksObjekt** b) {
+	Vector2 origin = PairOrigin(world);
+	FizziksAABB* aabbA = MakeAABB(world, origin, seed);
+	FizziksAABB* aabbB = MakeAABB(world, origin, seed);
+	float y = origin.y + (BenchRandom(seed) - 0.5f) * fminf(aabbA->sizeXY.y, aabbB->sizeXY.y);
+	aabbB->setPosition({ origin.x + aabbA->sizeXY.x + gap, y });
+	*a = aabbA;
+	*b = aabbB;
+}
+
+static void MakeAABBCircle(FizziksWorld& world, float gap, unsigned int& seed, FizziksObjekt** a, FizziksObjekt** b) {
+	Vector2 origin = PairOrigin(world);
+	FizziksAABB* aabb = MakeAABB(world, origin, seed);
+	FizziksCircle* circle = MakeCircle(world, origin, seed);
+	float y = origin.y + BenchRandom(seed) * aabb->sizeXY.y;
+	circle->setPosition({ origin.x + aabb->sizeXY.x + circle->radius + gap, y });
+	*a = aabb;
+	*b = circle;
+}
+
+// AABBHalfspaceContact only counts corners strictly under the surface, so a corner exactly on it
+// never touches. touching puts the lowest corner this far under instead, well above float rounding
+// at the pair origins but far too shallow to push anything visibly
+static const float halfspaceTouchDepth = 0.01f;
+
+// the halfspace goes under the box's lowest corner along its normal
+static void MakeAABBHalfspace(FizziksWorld& world, float gap, unsigned int& seed, FizziksObjekt** a, FizziksObjekt** b) {
+	Vector2 origin = PairOrigin(world);
+	FizziksAABB* aabb = MakeAABB(world, origin, seed);
+	FizziksHalfspace* halfspace = MakeHalfspace(world, origin, seed);
+
+	Vector2 n = halfspace->getNormal();
+	Vector2 corners[4] = { origin, { origin.x + aabb->sizeXY.x, origin.y }, { origin.x, origin.y + aabb->sizeXY.y }, origin + aabb->sizeXY };
+	Vector2 lowest = corners[0];
+	for (int i = 1; i < 4; i++) {
+		if (Vector2DotProduct(corners[i], n) < Vector2DotProduct(lowest, n)) lowest = corners[i];
+	}
+	halfspace->setPosition(lowest - n * (gap != 0 ? gap : -halfspaceTouchDepth));
+	*a = aabb;
+	*b = halfspace;
+}
+
+static bool CallCircleCircle(FizziksObjekt* a, FizziksObjekt* b, FizziksWorld& world) {
+	return CircleCircleOverlap((FizziksCircle*)a, (FizziksCircle*)b, world);
+}
+
+static bool CallCircleHalfspace(FizziksObjekt* a, FizziksObjekt* b, FizziksWorld& world) {
+	return CircleHalfspaceOverlap((FizziksCircle*)a, (FizziksHalfspace*)b, world);
+}
+
+static bool CallAABBAABB(FizziksObjekt* a, FizziksObjekt* b, FizziksWorld& world) {
+	return AABBAABBOverlap((FizziksAABB*)a, (FizziksAABB*)b, world);
+}
+
+static bool CallAABBCircle(FizziksObjekt* a, FizziksObjekt* b, FizziksWorld& world) {
+	return AABBCircleOverlap((FizziksAABB*)a, (FizziksCircle*)b, world);
+}
+
+static bool CallAABBHalfspace(FizziksObjekt* a, FizziksObjekt* b, FizziksWorld& world) {
+	return AABBHalfspaceOverlap((FizziksAABB*)a, (FizziksHalfspace*)b, world);
+}
+
+static const NarrowPhaseFunction functions[] = {
+	{ "CircleCircleOverlap", MakeCircleCircle, CallCircleCircle },
+	{ "CircleHalfspaceOverlap", MakeCircleHalfspace, CallCircleHalfspace },
+	{ "AABBAABBOverlap", MakeAABBAABB, CallAABBAABB },
+	{ "AABBCircleOverlap", MakeAABBCircle, CallAABBCircle },
+	{ "AABBHalfspaceOverlap", MakeAABBHalfspace, CallAABBHalfspace },
+};
+
+static const NarrowPhaseConfig configs[] = {
+	{ "overlapping", -4 },
+	{ "touching", 0 }, // right on the boundary, rounding decides about half of them (box vs halfspace always hits, see halfspaceTouchDepth)
+	{ "separated", 20 },
+};
+
+int RunNarrowPhaseBenchmark(int argc, char** argv) {
+	printf("narrow phase benchmark, %d pairs x %d batches per case\n\n", pairsPerBatch, batches);
+	printf("%-24s %-12s %10s %14s %6s\n", "function", "config", "ns/call", "calls/sec", "hit%");
+
+	for (const NarrowPhaseFunction& function : functions) {
+		for (const NarrowPhaseConfig& config : configs) {
+			FizziksWorld world;
+			std::vector<FizziksObjekt*> pairA(pairsPerBatch);
+			std::vector<FizziksObjekt*> pairB(pairsPerBatch);
+			unsigned int seed = 1;
+			for (int i = 0; i < pairsPerBatch; i++) function.make(world, config.gap, seed, &pairA[i], &pairB[i]);
+
+			FizziksBodies fresh = world.bodies;
+			double seconds = 0;
+			long long hits = 0;
+
+			for (int batch = 0; batch < batches; batch++) {
+				world.bodies.positionX = fresh.positionX;
+				world.bodies.positionY = fresh.positionY;
+				world.bodies.velocityX = fresh.velocityX;
+				world.bodies.velocityY = fresh.velocityY;
+				world.bodies.forceX = fresh.forceX;
+				world.bodies.forceY = fresh.forceY;
+
+				double start = BenchSeconds();
+				for (int i = 0; i < pairsPerBatch; i++) {
+					hits += function.call(pairA[i], pairB[i], world);
+				}
+				seconds += BenchSeconds() - start;
+			}
+			BenchKeep(world.bodies.positionX[0]);
+
+			double calls = (double)pairsPerBatch * batches;
+			double hitPercent = 100.0 * hits / calls;
+			printf("%-24s %-12s %10.2f %14.3e %6.1f\n", function.name, config.name, seconds * 1e9 / calls, calls / seconds, hitPercent);
+			BenchRecord("narrowphase", std::string(function.name) + "/" + config.name)
+				.metric("ns_per_call", seconds * 1e9 / calls)
+				.metric("calls_per_sec", calls / seconds)
+				.metric("hit_percent", hitPercent);
+
+			DestroyObjekts(world);
+		}
+	}
+
+	return 0;
+}
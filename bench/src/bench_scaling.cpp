@@ -0,0 +1,74 @@
+#include "bench.h"
+#include "fizziks.h"
+#include "scenes.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+// the same 50k rain stepped on 1, 2, 4 ... threads up to one per core (or --threads N).
+// the scene is stepped a while first so there are piles and islands to share out, not just falling
+int RunScalingBenchmark(int argc, char** argv) {
+	const int count = 50000;
+	const int settleFrames = 50;
+	const int frames = 100;
+	const float dt = 1.0f / 50;
+
+	int maxThreads = (int)std::thread::hardware_concurrency();
+	for (int i = 1; i + 1 < argc; i++) {
+		if (strcmp(argv[i], "--threads") == 0) maxThreads = atoi(argv[i + 1]);
+	}
+	if (maxThreads < 1) maxThreads = 1;
+
+	std::vector<int> threadCounts;
+	for (int threads = 1; threads < maxThreads; threads *= 2) threadCounts.push_back(threads);
+	threadCounts.push_back(maxThreads);
+
+	printf("thread scaling, %s scene, %d objekts, %d frames after %d to settle\n\n", FizziksSceneName(SCENE_MIXED_RAIN), count, frames, settleFrames);
+	printf("%7s %12s %12s %12s %9s %11s %8s\n", "threads", "avg ms", "min ms", "max ms", "speedup", "efficiency", "same");
+
+	double baseline = 0;
+	std::vector<float> baselinePositions;
+	for (int threads : threadCounts) {
+		FizziksWorld world;
+		world.threads.setThreadCount(threads);
+		MakeScene(world, SCENE_MIXED_RAIN, count);
+		for (int frame = 0; frame < settleFrames; frame++) world.update(dt);
+
+		double total = 0;
+		double fastest = 1e30;
+		double slowest = 0;
+		for (int frame = 0; frame < frames; frame++) {
+			double start = BenchSeconds();
+			world.update(dt);
+			double elapsed = BenchSeconds() - start;
+
+			total += elapsed;
+			fastest = std::min(fastest, elapsed);
+			slowest = std::max(slowest, elapsed);
+		}
+
+		// every thread count has to end up in exactly the same place
+		if (threads == 1) {
+			baseline = total;
+			baselinePositions = world.bodies.positionX;
+		}
+		bool same = world.bodies.positionX == baselinePositions;
+
+		double speedup = baseline / total;
+		printf("%7d %12.3f %12.3f %12.3f %8.2fx %10.0f%% %8s\n", threads, total * 1000 / frames, fastest * 1000, slowest * 1000,
+			speedup, speedup * 100 / threads, same ? "yes" : "NO");
+		BenchRecord("scaling", std::to_string(threads) + " threads", (int)world.objekts.size())
+			.metric("threads", threads)
+			.metric("avg_ms", total * 1000 / frames)
+			.metric("min_ms", fastest * 1000)
+			.metric("max_ms", slowest * 1000)
+			.metric("speedup", speedup)
+			.metric("deterministic", same ? 1 : 0);
+
+		DestroyObjekts(world);
+	}
+
+	return 0;
+}
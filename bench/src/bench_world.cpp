@@ -0,0 +1,52 @@
+#include "bench.h"
+#include "fizziks.h"
+#include "scenes.h"
+#include <algorithm>
+#include <cstdio>
+
+int RunWorldBenchmark(int argc, char** argv) {
+	const FizziksScene scenes[] = { SCENE_CIRCLE_PILE, SCENE_AABB_TOWER, SCENE_MIXED_RAIN };
+	const int counts[] = { 1000, 10000, 100000 };
+	const float dt = 1.0f / 50;
+
+	printf("world benchmark, %s broad phase\n\n", BroadphaseModeName(FizziksWorld().broadphaseMode));
+	printf("%-8s %8s %7s %12s %12s %12s %16s\n", "scene", "objekts", "frames", "avg ms", "min ms", "max ms", "objekt steps/s");
+
+	for (FizziksScene scene : scenes) {
+		for (int count : counts) {
+			// about the same number of objekt steps at every size
+			int frames = std::max(10, 2000000 / count);
+
+			FizziksWorld world;
+			MakeScene(world, scene, count);
+
+			double total = 0;
+			double fastest = 1e30;
+			double slowest = 0;
+			for (int frame = 0; frame < frames; frame++) {
+				double start = BenchSeconds();
+				world.update(dt);
+				double elapsed = BenchSeconds() - start;
+
+				total += elapsed;
+				fastest = std::min(fastest, elapsed);
+				slowest = std::max(slowest, elapsed);
+			}
+
+			int objekts = (int)world.objekts.size();
+			double stepsPerSecond = (double)objekts * frames / total;
+			printf("%-8s %8d %7d %12.3f %12.3f %12.3f %16.3e\n", FizziksSceneName(scene), objekts, frames,
+				total * 1000 / frames, fastest * 1000, slowest * 1000, stepsPerSecond);
+			BenchRecord("world", FizziksSceneName(scene), objekts)
+				.metric("frames", frames)
+				.metric("avg_ms", total * 1000 / frames)
+				.metric("min_ms", fastest * 1000)
+				.metric("max_ms", slowest * 1000)
+				.metric("objekt_steps_per_sec", stepsPerSecond);
+
+			DestroyObjekts(world);
+		}
+	}
+
+	return 0;
+}
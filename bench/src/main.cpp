@@ -0,0 +1,63 @@
+/*
+Benchmarks for the physics code. Nothing here opens a window.
+
+usage: physics-bench <suite> [--json FILE]
+	integrator    scalar vs simd gravity and kinematics at 10k, 100k and 1M bodies
+	narrowphase   ns per call of every narrow phase function, overlapping, touching and separated
+	world         whole world steps of the pile, tower and rain scenes at 1k, 10k and 100k objekts
+	scaling       50k objekt rain on 1, 2, 4 ... threads up to one per core, or --threads N
+	all           every suite above (the default)
+
+--json FILE writes every result to FILE as well, to diff against a previous run
+*/
+
+#include "bench.h"
+#include <cstdio>
+#include <cstring>
+
+struct BenchSuite {
+	const char* name;
+	int (*run)(int argc, char** argv);
+};
+
+static const BenchSuite suites[] = {
+	{ "integrator", RunIntegratorBenchmark },
+	{ "narrowphase", RunNarrowPhaseBenchmark },
+	{ "world", RunWorldBenchmark },
+	{ "scaling", RunScalingBenchmark },
+};
+
+int main(int argc, char** argv)
+{
+	// pull --json out before the suites see the arguments
+	const char* jsonPath = nullptr;
+	int kept = 1;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) jsonPath = argv[++i];
+		else argv[kept++] = argv[i];
+	}
+	argc = kept;
+
+	const char* wanted = argc > 1 ? argv[1] : nullptr;
+
+	int result = 0;
+	bool ranAny = false;
+	for (const BenchSuite& suite : suites) {
+		if (wanted != nullptr && strcmp(wanted, "all") != 0 && strcmp(wanted, suite.name) != 0) continue;
+		ranAny = true;
+		result |= suite.run(argc - 1, argv + 1);
+	}
+
+	if (!ranAny) {
+		printf("unknown suite '%s', pick one of:", wanted);
+		for (const BenchSuite& suite : suites) printf(" %s", suite.name);
+		printf(" all\n");
+		return 1;
+	}
+
+	if (jsonPath != nullptr && !BenchWriteJson(jsonPath)) {
+		printf("couldn't write %s\n", jsonPath);
+		result = 1;
+	}
+	return result;
+}
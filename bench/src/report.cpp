@@ -0,0 +1,52 @@
+#include "bench.h"
+#include "integrator.h"
+#include <cmath>
+#include <cstdio>
+#include <deque>
+
+// deque so the references BenchRecord hands out stay put
+static std::deque<BenchResult> results;
+
+BenchResult& BenchRecord(const char* suite, const std::string& name, int count) {
+	results.emplace_back();
+	BenchResult& result = results.back();
+	result.suite = suite;
+	result.name = name;
+	result.count = count;
+	return result;
+}
+
+static void WriteJsonString(FILE* file, const std::string& text) {
+	fputc('"', file);
+	for (char c : text) {
+		if (c == '"' || c == '\\') fputc('\\', file);
+		fputc(c, file);
+	}
+	fputc('"', file);
+}
+
+bool BenchWriteJson(const char* path) {
+	FILE* file = fopen(path, "w");
+	if (file == nullptr) return false;
+
+	fprintf(file, "{\n\t\"simd\": \"%s\",\n\t\"results\": [", FizziksSimdLevelName(FizziksBestSimdLevel()));
+	for (size_t i = 0; i < results.size(); i++) {
+		const BenchResult& result = results[i];
+		fprintf(file, "%s\n\t\t{ \"suite\": ", i == 0 ? "" : ",");
+		WriteJsonString(file, result.suite);
+		fprintf(file, ", \"name\": ");
+		WriteJsonString(file, result.name);
+		fprintf(file, ", \"count\": %d", result.count);
+		for (size_t m = 0; m < result.metricNames.size(); m++) {
+			fprintf(file, ", ");
+			WriteJsonString(file, result.metricNames[m]);
+			if (std::isfinite(result.metricValues[m])) fprintf(file, ": %.6g", result.metricValues[m]);
+			else fprintf(file, ": null");
+		}
+		fprintf(file, " }");
+	}
+	fprintf(file, "\n\t]\n}\n");
+
+	fclose(file);
+	return true;
+}
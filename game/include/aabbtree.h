@@ -0,0 +1,132 @@
+#pragma once
+
+#include "raylib.h"
+#include "broadphase.h"
+#include <vector>
+
+// dynamic bounding volume tree. leaves hold a fattened copy of each objekt's bounds
+// so small movements don't touch the tree at all, and internal nodes are kept
+// balanced with rotations as leaves come and go.
+//
+// each leaf carries the objekt's current index into FizziksWorld::objekts, which
+// gets refreshed by move() every step.
+class FizziksAABBTree {
+public:
+	float margin = 8; // pixels added on every side of a leaf's bounds
+	float displacementMultiplier = 2; // how far ahead of its velocity a leaf's bounds stretch
+
+	// returns the proxy to keep for move() and remove()
+	int insert(int index, Rectangle bounds);
+	void remove(int proxy);
+
+	// returns true if the leaf had to be reinserted
+	bool move(int proxy, int index, Rectangle bounds, Vector2 displacement);
+
+	// appends pairs whose tight bounds overlap, sorted by (a, b)
+	void findPairs(std::vector<FizziksPair>& pairs);
+
+	// indices of every leaf whose fat bounds contain/overlap the query. the tight bounds are from the
+	// last move(), so the caller checks each one against where the objekt is now
+	void queryPoint(Vector2 point, std::vector<int>& indices);
+	void queryRect(Rectangle rect, std::vector<int>& indices);
+
+	// walks the leaves the segment from -> to passes through. callback(index, maxFraction)
+	// returns the fraction along the segment to clip the ray to, or maxFraction to keep going,
+	// or 0 to stop.
+	template <typename Callback>
+	void raycast(Vector2 from, Vector2 to, Callback callback);
+
+	int leafIndex(int proxy) const { return nodes[proxy].index; }
+	void setLeafIndex(int proxy, int index) { nodes[proxy].index = index; }
+	Rectangle fatBounds(int proxy) const;
+	// the fat bounds of every node in use, leaves and the ones above them
+	void nodeBounds(std::vector<Rectangle>& bounds) const;
+	int height() const { return root < 0 ? 0 : nodes[root].height; }
+	int leafCount() const { return leaves; }
+
+private:
+	struct Box {
+		float minX, minY, maxX, maxY;
+	};
+
+	struct Node {
+		Box fat;
+		Box tight; // leaves only
+		int parent = -1; // next free node when on the free list
+		int child1 = -1;
+		int child2 = -1;
+		int height = -1; // 0 for leaves, -1 when free
+		int index = -1;
+
+		bool isLeaf() const { return child1 < 0; }
+	};
+
+	std::vector<Node> nodes;
+	int root = -1;
+	int freeList = -1;
+	int leaves = 0;
+	std::vector<int> stack;
+
+	int allocateNode();
+	void freeNode(int node);
+	void insertLeaf(int leaf);
+	void removeLeaf(int leaf);
+	int balance(int node);
+
+	static Box toBox(Rectangle r);
+	static Box combine(const Box& a, const Box& b);
+	static bool contains(const Box& outer, const Box& inner);
+	static bool overlaps(const Box& a, const Box& b);
+	static float perimeter(const Box& b);
+};
+
+template <typename Callback>
+void FizziksAABBTree::raycast(Vector2 from, Vector2 to, Callback callback) {
+	if (root < 0) return;
+
+	Vector2 d = { to.x - from.x, to.y - from.y };
+	float maxFraction = 1.0f;
+
+	stack.clear();
+	stack.push_back(root);
+
+	while (!stack.empty()) {
+		int id = stack.back();
+		stack.pop_back();
+		const Node& node = nodes[id];
+
+		// slab test against the node's fat box, clipped to the current max fraction
+		float tMin = 0.0f;
+		float tMax = maxFraction;
+		float origin[2] = { from.x, from.y };
+		float direction[2] = { d.x, d.y };
+		float boxMin[2] = { node.fat.minX, node.fat.minY };
+		float boxMax[2] = { node.fat.maxX, node.fat.maxY };
+		bool hit = true;
+
+		for (int axis = 0; axis < 2 && hit; axis++) {
+			if (direction[axis] == 0.0f) {
+				if (origin[axis] < boxMin[axis] || origin[axis] > boxMax[axis]) hit = false;
+				continue;
+			}
+			float inverse = 1.0f / direction[axis];
+			float t1 = (boxMin[axis] - origin[axis]) * inverse;
+			float t2 = (boxMax[axis] - origin[axis]) * inverse;
+			if (t1 > t2) { float t = t1; t1 = t2; t2 = t; }
+			if (t1 > tMin) tMin = t1;
+			if (t2 < tMax) tMax = t2;
+			if (tMin > tMax) hit = false;
+		}
+		if (!hit) continue;
+
+		if (node.isLeaf()) {
+			float fraction = callback(node.index, maxFraction);
+			if (fraction == 0.0f) return;
+			if (fraction > 0.0f && fraction < maxFraction) maxFraction = fraction;
+		}
+		else {
+			stack.push_back(node.child1);
+			stack.push_back(node.child2);
+		}
+	}
+}
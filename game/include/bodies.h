@@ -0,0 +1,93 @@
+#pragma once
+
+#include "raylib.h"
+#include <vector>
+
+enum FizziksBodyFlags : unsigned char {
+	BODY_STATIC = 1 << 0,
+	BODY_DEAD = 1 << 1, // waiting for removeDead() at the end of the step
+	BODY_SLEEPING = 1 << 2, // its island has been still for a while, see FizziksIslands
+	BODY_BULLET = 1 << 3, // swept against everything it passes each step, see FizziksWorld::sweepBullets()
+	BODY_NOT_MOVING = BODY_STATIC | BODY_SLEEPING // neither pulled by gravity nor integrated
+};
+
+// stays valid while the body is alive no matter how the arrays get shuffled.
+// the generation goes up every time a slot is reused so stale handles are caught
+struct FizziksBodyHandle {
+	unsigned int slot = 0xFFFFFFFF;
+	unsigned int generation = 0;
+};
+
+// everything about a body that isn't stored in FizziksBodies yet, or anymore
+struct FizziksBodyState {
+	Vector2 position = { 0,0 };
+	Vector2 velocity = { 0,0 };
+	Vector2 netForce = { 0,0 };
+	float mass = 1; // in kg
+	bool isStatic = false;
+	bool isBullet = false;
+};
+
+// structure of arrays body storage. index i in every array is the same body, so
+// the integrator and gravity pass walk straight through memory instead of
+// chasing an objekt pointer per body.
+class FizziksBodies {
+public:
+	std::vector<float> positionX;
+	std::vector<float> positionY;
+	std::vector<float> velocityX;
+	std::vector<float> velocityY;
+	std::vector<float> forceX;
+	std::vector<float> forceY;
+	std::vector<float> mass;
+	std::vector<float> inverseMass; // 0 for static bodies
+	std::vector<unsigned char> flags;
+	std::vector<float> sleepTime; // seconds it's been slower than the world's sleep speed
+	std::vector<float> previousX; // position before the last fixed step, to draw in between steps
+	std::vector<float> previousY;
+
+	// set by the world for the length of a step. outside of one, moving a body by hand is a
+	// teleport and previousX/Y go with it, so it isn't drawn sliding over from where it was
+	bool stepping = false;
+
+	FizziksBodyHandle create(const FizziksBodyState& state);
+
+	// erases the body, keeping everyone else in the same order
+	void destroy(FizziksBodyHandle handle);
+	// O(1): the last body moves into the hole, so whatever mirrors these arrays has to do the same
+	void destroySwap(FizziksBodyHandle handle);
+	// drops every body flagged BODY_DEAD in one pass, the rest keep their order
+	void removeDead();
+
+	// -1 if the handle is stale
+	int indexOf(FizziksBodyHandle handle) const;
+	bool isValid(FizziksBodyHandle handle) const { return indexOf(handle) >= 0; }
+	FizziksBodyHandle handleAt(int index) const;
+
+	FizziksBodyState getState(int index) const;
+	void setState(int index, const FizziksBodyState& state);
+
+	void setMass(int index, float newMass);
+	void setStatic(int index, bool isStatic);
+	void setBullet(int index, bool isBullet);
+
+	// clears BODY_SLEEPING and starts the still timer over, so it stays up at least that long
+	void wake(int index) {
+		flags[index] &= ~BODY_SLEEPING;
+		sleepTime[index] = 0;
+	}
+
+	int size() const { return (int)positionX.size(); }
+	void reserve(int count);
+	void clear();
+
+private:
+	struct Slot {
+		int index = -1; // into the arrays, or the next free slot when unused
+		unsigned int generation = 0;
+	};
+
+	std::vector<Slot> slots;
+	std::vector<unsigned int> slotOf; // per body, which slot points at it
+	int freeSlot = -1;
+};
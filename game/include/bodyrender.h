@@ -0,0 +1,49 @@
+#pragma once
+
+#include "fizziks.h"
+#include "instancing.h"
+#include "debugrender.h"
+#include <vector>
+
+// laid out to go straight into the instance buffers
+struct FizziksCircleInstance {
+	Vector2 center;
+	float radius;
+	Color color;
+};
+
+struct FizziksRectInstance {
+	Rectangle rect;
+	Color color;
+};
+
+// draws every circle and box in the world with one instanced call per shape. the positions,
+// sizes and colours go up in one buffer per shape and the gpu does the rest: circles are a
+// quad each, cut round by their distance from the centre in the fragment shader, boxes a quad
+// each as they are. half-spaces are left to the caller, there's only ever a few.
+// without gl 3.3 it falls back to DrawCircleV and DrawRectangleRec
+class FizziksBodyRenderer {
+public:
+	bool drawVelocities = true; // a line from every circle's centre along its velocity
+
+	// after InitWindow, and unload before CloseWindow
+	void load();
+	void unload();
+
+	// everything with bounds inside view, interpolation as from FizziksWorld::interpolation().
+	// sleeping bodies are drawn darker. between BeginDrawing and EndDrawing
+	void draw(const FizziksWorld& world, float interpolation, Rectangle view);
+
+	int drawnCircles() const { return (int)circles.size(); }
+	int drawnRects() const { return (int)rects.size(); }
+	bool instanced() const { return circleQuads.isLoaded() && rectQuads.isLoaded(); }
+
+private:
+	FizziksInstancedQuads circleQuads;
+	FizziksInstancedQuads rectQuads;
+	FizziksDebugRenderer velocityRenderer;
+
+	std::vector<FizziksCircleInstance> circles;
+	std::vector<FizziksRectInstance> rects;
+	std::vector<FizziksDebugLine> velocities;
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "raylib.h"
+#include "threadpool.h"
+#include <vector>
+
+// candidate pair from a broad phase, indices into FizziksWorld::objekts with a < b
+struct FizziksPair {
+	int a;
+	int b;
+};
+
+enum FizziksBroadphaseMode {
+	BROADPHASE_BRUTE_FORCE,
+	BROADPHASE_SPATIAL_HASH,
+	BROADPHASE_SWEEP_AND_PRUNE,
+	BROADPHASE_AABB_TREE
+};
+
+// uniform grid spatial hash. every object goes into each cell its bounds touch,
+// and a pair is only reported by the cell holding the top-left corner of the
+// two bounds' overlap so it comes out once no matter how many cells they share.
+class FizziksSpatialHash {
+public:
+	float cellSize = 64; // in pixels
+
+	void clear();
+	void insert(int index, Rectangle bounds);
+
+	// appends candidate pairs sorted by (a, b), the same order the brute force loop visits them
+	void findPairs(std::vector<FizziksPair>& pairs);
+	// the same, with the cells shared out between the threads
+	void findPairs(std::vector<FizziksPair>& pairs, FizziksThreadPool& threads);
+
+	int cellCount() const { return occupiedCells; }
+	// the square of one occupied cell, cell in [0, cellCount()) after findPairs()
+	Rectangle cellBounds(int cell) const;
+
+private:
+	struct Proxy {
+		int index;
+		Rectangle bounds;
+	};
+
+	struct Entry {
+		int cellX;
+		int cellY;
+		int proxy;
+	};
+
+	std::vector<Proxy> proxies;
+	std::vector<Entry> entries;
+	std::vector<int> cellStarts; // where each occupied cell's run of entries begins, plus the end
+	std::vector<std::vector<FizziksPair>> workerPairs;
+	int occupiedCells = 0;
+
+	int cellCoord(float v) const;
+	void sortIntoCells();
+	void cellPairs(int cell, std::vector<FizziksPair>& pairs) const;
+};
+
+// sort and sweep over min/max endpoint lists that persist between steps. objekts
+// barely move from one step to the next so the lists stay almost sorted and an
+// insertion sort puts them back in close to linear time.
+//
+// proxies are stamped every step by update(); any proxy that wasn't touched
+// since the last findPairs() belongs to an objekt that is gone and is freed.
+class FizziksSweepAndPrune {
+public:
+	// creates the proxy if proxy == -1, returns the proxy to keep for next step
+	int update(int proxy, int index, Rectangle bounds);
+
+	// appends candidate pairs sorted by (a, b)
+	void findPairs(std::vector<FizziksPair>& pairs);
+
+	int proxyCount() const { return (int)proxies.size() - (int)freeProxies.size(); }
+	int axis() const { return sweepAxis; }
+
+private:
+	struct Proxy {
+		int index = -1; // objekt index this step, -1 when free
+		Rectangle bounds = { 0,0,0,0 };
+		unsigned int stamp = 0;
+	};
+
+	struct Endpoint {
+		float value;
+		int proxy;
+		bool isMax;
+	};
+
+	std::vector<Proxy> proxies;
+	std::vector<int> freeProxies;
+	std::vector<Endpoint> endpoints[2]; // x and y
+	std::vector<int> active;
+	std::vector<int> activeSlot; // per proxy, where it sits in active
+	unsigned int stamp = 1;
+	int sweepAxis = 0;
+	int addedEndpoints = 0; // per list, since the last refresh
+
+	void removeStaleProxies();
+	void refreshEndpoints(int axis);
+};
+
+bool BoundsOverlap(Rectangle a, Rectangle b);
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "raylib.h"
+#include <vector>
+
+// what the physics can show about itself. each is turned on in FizziksDebugDraw::categories
+enum FizziksDebugCategory {
+	DEBUG_FORCES = 1 << 0, // gravity and the old immediate contact forces
+	DEBUG_CONTACTS = 1 << 1, // solver impulses at every contact point, and where bullets were stopped
+	DEBUG_AABBS = 1 << 2, // every objekt's bounds
+	DEBUG_BROADPHASE = 1 << 3, // occupied grid cells, or every node of the tree
+	DEBUG_CATEGORY_COUNT = 4
+};
+
+// laid out to go straight into a vertex buffer as one instance per line
+struct FizziksDebugLine {
+	Vector2 start;
+	Vector2 end;
+	float thickness;
+	Color color;
+};
+
+// lines the physics wants drawn, kept until the game gets round to drawing them inside
+// BeginDrawing instead of drawn halfway through a step. the world clears it at the start of
+// every update(), so between steps it holds the last one. anything in a category that's
+// off is never recorded, and callers check wants() first to skip working out the line too.
+// only the thread calling update() records
+class FizziksDebugDraw {
+public:
+	unsigned int categories = 0; // FizziksDebugCategory bits, nothing by default
+
+	bool wants(FizziksDebugCategory category) const { return (categories & category) != 0; }
+
+	void line(FizziksDebugCategory category, Vector2 start, Vector2 end, float thickness, Color color) {
+		if (wants(category)) lines.push_back({ start, end, thickness, color });
+	}
+	void rect(FizziksDebugCategory category, Rectangle rect, float thickness, Color color);
+	void clear() { lines.clear(); }
+
+	int count() const { return (int)lines.size(); }
+	const std::vector<FizziksDebugLine>& all() const { return lines; }
+
+	// copies out the lines that could show up inside view
+	void cull(Rectangle view, std::vector<FizziksDebugLine>& visible) const;
+
+private:
+	std::vector<FizziksDebugLine> lines;
+};
+
+const char* FizziksDebugCategoryName(FizziksDebugCategory category);
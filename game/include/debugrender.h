@@ -0,0 +1,29 @@
+#pragma once
+
+#include "debugdraw.h"
+#include "instancing.h"
+#include <vector>
+
+// draws a FizziksDebugDraw's lines in one instanced draw call: every line is an instance of the
+// same quad, stretched between its ends in the vertex shader, so the whole lot costs one buffer
+// upload instead of a trip through rlgl's batch per line. without gl 3.3 it falls back to DrawLineEx.
+// the game's side of the debug lines, it needs a window so the headless runner never has one
+class FizziksDebugRenderer {
+public:
+	// after InitWindow, and unload before CloseWindow
+	void load();
+	void unload() { quads.unload(); }
+
+	// the lines that land inside view, on top of whatever's been drawn so far. between BeginDrawing and EndDrawing
+	void draw(const FizziksDebugDraw& debugDraw, Rectangle view);
+	// lines that are already culled
+	void drawLines(const std::vector<FizziksDebugLine>& lines);
+
+	int drawnLines() const { return drawn; }
+	bool instanced() const { return quads.isLoaded(); }
+
+private:
+	FizziksInstancedQuads quads;
+	std::vector<FizziksDebugLine> visible;
+	int drawn = 0;
+};
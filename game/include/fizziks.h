@@ -0,0 +1,526 @@
+#pragma once
+
+#include "raylib.h"
+#include "raymath.h"
+#include "broadphase.h"
+#include "aabbtree.h"
+#include "bodies.h"
+#include "integrator.h"
+#include "pool.h"
+#include "threadpool.h"
+#include "solver.h"
+#include "islands.h"
+#include "profiler.h"
+#include "debugdraw.h"
+#include <string>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+// the simulation without any window, shared by the game and the headless runner
+
+enum FizziksShape {
+	CIRCLE,
+	HALF_SPACE,
+	AABB,
+	SHAPE_COUNT // keep last, sizes the collision table
+};
+
+class FizziksObjekt {
+private:
+	// position, velocity etc. live in the world's FizziksBodies once the objekt is added,
+	// until then (and after it's removed) they're kept here
+	FizziksBodies* bodies = nullptr;
+	FizziksBodyHandle body;
+	FizziksBodyState detached;
+
+	FizziksShape shape;
+
+protected:
+	FizziksObjekt(FizziksShape objektShape) : shape(objektShape) {}
+
+public:
+	float grippiness = 0.5f;
+
+	float bounciness = 0.9f; // for determining coefficient of restitution
+
+	std::string name = "objekt";
+	Color color = GREEN;
+	Color baseColor = GREEN;
+
+	int broadphaseProxy = -1; // sweep and prune proxy, kept between steps
+	int treeProxy = -1; // leaf in FizziksWorld::tree
+	bool pooled = false; // made by one of FizziksWorld's create functions, goes back to its pool on destroy
+
+	virtual ~FizziksObjekt() {}
+
+	void attach(FizziksBodies* newBodies) {
+		bodies = newBodies;
+		body = bodies->create(detached);
+	}
+
+	// the world's last body moves into this one's place
+	void detach() {
+		int i = bodyIndex();
+		if (i >= 0) {
+			detached = bodies->getState(i);
+			bodies->destroySwap(body);
+		}
+		bodies = nullptr;
+	}
+
+	// lets go of the body without touching the arrays, for when the world is about to
+	// sweep a whole batch of dead bodies out at once
+	void release() {
+		int i = bodyIndex();
+		if (i >= 0) detached = bodies->getState(i);
+		bodies = nullptr;
+	}
+
+	bool isDead() const {
+		int i = bodyIndex();
+		return i >= 0 && (bodies->flags[i] & BODY_DEAD) != 0;
+	}
+
+	// index into the world's body arrays, or -1 when not in a world
+	int bodyIndex() const {
+		return bodies ? bodies->indexOf(body) : -1;
+	}
+
+	FizziksBodyHandle getHandle() const {
+		return body;
+	}
+
+	Vector2 getPosition() const {
+		int i = bodyIndex();
+		if (i < 0) return detached.position;
+		return { bodies->positionX[i], bodies->positionY[i] };
+	}
+
+	void setPosition(Vector2 position) {
+		int i = bodyIndex();
+		if (i < 0) { detached.position = position; return; }
+		bodies->positionX[i] = position.x;
+		bodies->positionY[i] = position.y;
+		if (!bodies->stepping) {
+			bodies->previousX[i] = position.x;
+			bodies->previousY[i] = position.y;
+		}
+		bodies->wake(i);
+	}
+
+	// where to draw it, alpha of the way from before the last fixed step to now (FizziksWorld::interpolation())
+	Vector2 getInterpolatedPosition(float alpha) const {
+		int i = bodyIndex();
+		if (i < 0) return detached.position;
+		return { Lerp(bodies->previousX[i], bodies->positionX[i], alpha), Lerp(bodies->previousY[i], bodies->positionY[i], alpha) };
+	}
+
+	Vector2 getVelocity() const {
+		int i = bodyIndex();
+		if (i < 0) return detached.velocity;
+		return { bodies->velocityX[i], bodies->velocityY[i] };
+	}
+
+	void setVelocity(Vector2 velocity) {
+		int i = bodyIndex();
+		if (i < 0) { detached.velocity = velocity; return; }
+		bodies->velocityX[i] = velocity.x;
+		bodies->velocityY[i] = velocity.y;
+		bodies->wake(i);
+	}
+
+	Vector2 getNetForce() const {
+		int i = bodyIndex();
+		if (i < 0) return detached.netForce;
+		return { bodies->forceX[i], bodies->forceY[i] };
+	}
+
+	void setNetForce(Vector2 netForce) {
+		int i = bodyIndex();
+		if (i < 0) { detached.netForce = netForce; return; }
+		bodies->forceX[i] = netForce.x;
+		bodies->forceY[i] = netForce.y;
+		bodies->wake(i);
+	}
+
+	float getMass() const {
+		int i = bodyIndex();
+		return i < 0 ? detached.mass : bodies->mass[i];
+	}
+
+	void setMass(float mass) {
+		int i = bodyIndex();
+		if (i < 0) detached.mass = mass;
+		else bodies->setMass(i, mass);
+	}
+
+	bool isStatic() const {
+		int i = bodyIndex();
+		return i < 0 ? detached.isStatic : (bodies->flags[i] & BODY_STATIC) != 0;
+	}
+
+	void setStatic(bool isStatic) {
+		int i = bodyIndex();
+		if (i < 0) detached.isStatic = isStatic;
+		else bodies->setStatic(i, isStatic);
+	}
+
+	// fast movers (birds off the slingshot) that would jump clean over something thin in one
+	// step. costs a sweep per step, so leave it off for everything else
+	bool isBullet() const {
+		int i = bodyIndex();
+		return i < 0 ? detached.isBullet : (bodies->flags[i] & BODY_BULLET) != 0;
+	}
+
+	void setBullet(bool isBullet) {
+		int i = bodyIndex();
+		if (i < 0) detached.isBullet = isBullet;
+		else bodies->setBullet(i, isBullet);
+	}
+
+	// the set functions above wake it too, the world doesn't tell a nudge from anything else
+	bool isSleeping() const {
+		int i = bodyIndex();
+		return i >= 0 && (bodies->flags[i] & BODY_SLEEPING) != 0;
+	}
+
+	void wake() {
+		int i = bodyIndex();
+		if (i >= 0) bodies->wake(i);
+	}
+
+	// world space box around the objekt for the broad phase
+	virtual Rectangle getBounds() {
+		Vector2 position = getPosition();
+		return { position.x, position.y, 0, 0 };
+	}
+
+	virtual bool containsPoint(Vector2 point) {
+		return false;
+	}
+
+	// fraction along from -> to where the segment first enters the objekt, or -1 for a miss
+	virtual float raycast(Vector2 from, Vector2 to) {
+		return -1;
+	}
+
+	// plain member rather than virtual, the narrow phase asks for it on every pair
+	FizziksShape Shape() const {
+		return shape;
+	}
+};
+
+
+
+class FizziksCircle : public FizziksObjekt {
+public:
+	FizziksCircle() : FizziksObjekt(CIRCLE) {}
+
+	float radius = 15; // circle radius in pixels
+	std::string tag = "pig";
+
+	Rectangle getBounds() override {
+		Vector2 position = getPosition();
+		return { position.x - radius, position.y - radius, radius * 2, radius * 2 };
+	}
+
+	bool containsPoint(Vector2 point) override {
+		return Vector2DistanceSqr(point, getPosition()) <= radius * radius;
+	}
+
+	float raycast(Vector2 from, Vector2 to) override {
+		Vector2 d = to - from;
+		Vector2 f = from - getPosition();
+
+		float a = Vector2DotProduct(d, d);
+		float b = 2 * Vector2DotProduct(f, d);
+		float c = Vector2DotProduct(f, f) - radius * radius;
+		if (c <= 0) return 0; // starts inside
+		if (a <= 0) return -1;
+
+		float discriminant = b * b - 4 * a * c;
+		if (discriminant < 0) return -1;
+
+		float t = (-b - sqrtf(discriminant)) / (2 * a);
+		return (t >= 0 && t <= 1) ? t : -1;
+	}
+
+};
+
+
+class FizziksHalfspace : public FizziksObjekt {
+private:
+	float rotation = 0;
+	Vector2 normal = { 0, -1 };
+
+public:
+	FizziksHalfspace() : FizziksObjekt(HALF_SPACE) {}
+
+	void setRotationDegrees(float rotationDegrees) {
+		rotation = rotationDegrees;
+		normal = Vector2Rotate({ 0, -1 }, rotation * DEG2RAD);
+	}
+
+	float getRotation() const {
+		return rotation;
+	}
+
+	Vector2 getNormal() const {
+		return normal;
+	}
+
+};
+
+class FizziksAABB : public FizziksObjekt {
+public:
+	FizziksAABB() : FizziksObjekt(AABB) {}
+
+	Vector2 sizeXY = { 10,10 };
+
+	Rectangle getBounds() override {
+		Vector2 position = getPosition();
+		return { position.x, position.y, sizeXY.x, sizeXY.y };
+	}
+
+	bool containsPoint(Vector2 point) override {
+		Vector2 position = getPosition();
+		return point.x >= position.x && point.x <= position.x + sizeXY.x
+			&& point.y >= position.y && point.y <= position.y + sizeXY.y;
+	}
+
+	float raycast(Vector2 from, Vector2 to) override {
+		float tMin = 0;
+		float tMax = 1;
+		Vector2 position = getPosition();
+		float origin[2] = { from.x, from.y };
+		float direction[2] = { to.x - from.x, to.y - from.y };
+		float boxMin[2] = { position.x, position.y };
+		float boxMax[2] = { position.x + sizeXY.x, position.y + sizeXY.y };
+
+		for (int axis = 0; axis < 2; axis++) {
+			if (direction[axis] == 0) {
+				if (origin[axis] < boxMin[axis] || origin[axis] > boxMax[axis]) return -1;
+				continue;
+			}
+			float t1 = (boxMin[axis] - origin[axis]) / direction[axis];
+			float t2 = (boxMax[axis] - origin[axis]) / direction[axis];
+			if (t1 > t2) std::swap(t1, t2);
+			tMin = fmaxf(tMin, t1);
+			tMax = fminf(tMax, t2);
+			if (tMin > tMax) return -1;
+		}
+		return tMin;
+	}
+
+};
+
+class FizziksWorld;
+
+enum FizziksSolverMode {
+	SOLVER_SEQUENTIAL_IMPULSE,
+	SOLVER_IMMEDIATE // each contact pushes itself apart on the spot, the old way
+};
+
+// what happens to a non-static objekt that leaves FizziksWorld::bounds
+enum FizziksBoundsPolicy {
+	BOUNDS_NONE,
+	BOUNDS_KILL, // destroyed at the end of the step
+	BOUNDS_CLAMP, // stopped with its whole extent inside the edge
+	BOUNDS_WRAP // comes back in on the other side
+};
+
+// narrow phase detection, fills in the geometry of the contact. only reads the objekts so
+// these are safe to run from several threads at once
+bool CircleCircleContact(const FizziksCircle* circleA, const FizziksCircle* circleB, FizziksContact* contact);
+bool CircleHalfspaceContact(const FizziksCircle* circle, const FizziksHalfspace* halfspace, FizziksContact* contact);
+bool AABBAABBContact(const FizziksAABB* aabbA, const FizziksAABB* aabbB, FizziksContact* contact);
+bool AABBCircleContact(const FizziksAABB* aabb, const FizziksCircle* circle, FizziksContact* contact);
+bool AABBHalfspaceContact(const FizziksAABB* aabb, const FizziksHalfspace* halfspace, FizziksContact* contact);
+
+// immediate resolution of a contact found above, pair by pair with no solver (SOLVER_IMMEDIATE)
+void CircleCircleResolve(FizziksCircle* circleA, FizziksCircle* circleB, const FizziksContact& contact, FizziksWorld& world);
+void CircleHalfspaceResolve(FizziksCircle* circle, FizziksHalfspace* halfspace, const FizziksContact& contact, FizziksWorld& world);
+void AABBAABBResolve(FizziksAABB* aabbA, FizziksAABB* aabbB, const FizziksContact& contact, FizziksWorld& world);
+void AABBCircleResolve(FizziksAABB* aabb, FizziksCircle* circle, const FizziksContact& contact, FizziksWorld& world);
+void AABBHalfspaceResolve(FizziksAABB* aabb, FizziksHalfspace* halfspace, const FizziksContact& contact, FizziksWorld& world);
+
+// both of the above, returns true if they touched
+bool CircleCircleOverlap(FizziksCircle* circleA, FizziksCircle* circleB, FizziksWorld& world);
+bool CircleHalfspaceOverlap(FizziksCircle* circle, FizziksHalfspace* halfspace, FizziksWorld& world);
+bool AABBAABBOverlap(FizziksAABB* aabbA, FizziksAABB* aabbB, FizziksWorld& world);
+bool AABBCircleOverlap(FizziksAABB* aabb, FizziksCircle* circle, FizziksWorld& world);
+bool AABBHalfspaceOverlap(FizziksAABB* aabb, FizziksHalfspace* halfspace, FizziksWorld& world);
+
+// swept tests for bullets: the first shape goes from start to start + motion, the second stays
+// where it is. fraction of motion at first touch, and the normal from the first into the second.
+// false if it never touches, or already overlaps at start (the narrow phase deals with that)
+bool CircleCircleTimeOfImpact(const FizziksCircle* circle, Vector2 start, Vector2 motion, const FizziksCircle* other, float* fraction, Vector2* normal);
+bool CircleAABBTimeOfImpact(const FizziksCircle* circle, Vector2 start, Vector2 motion, const FizziksAABB* aabb, float* fraction, Vector2* normal);
+bool CircleHalfspaceTimeOfImpact(const FizziksCircle* circle, Vector2 start, Vector2 motion, const FizziksHalfspace* halfspace, float* fraction, Vector2* normal);
+bool AABBAABBTimeOfImpact(const FizziksAABB* aabb, Vector2 start, Vector2 motion, const FizziksAABB* other, float* fraction, Vector2* normal);
+bool AABBCircleTimeOfImpact(const FizziksAABB* aabb, Vector2 start, Vector2 motion, const FizziksCircle* circle, float* fraction, Vector2* normal);
+bool AABBHalfspaceTimeOfImpact(const FizziksAABB* aabb, Vector2 start, Vector2 motion, const FizziksHalfspace* halfspace, float* fraction, Vector2* normal);
+
+class FizziksWorld {
+public:
+	std::vector<FizziksObjekt*> objekts; // objekts[i] owns bodies index i
+	FizziksBodies bodies;
+	FizziksSimdLevel simdLevel = FizziksBestSimdLevel();
+
+	Vector2 accelerationGravity = { 0, 50 };
+	float dt = 1.0f / 50; // length of the last substep
+
+	// advance() steps the world fixedStep at a time however long the frames take, each step
+	// split into substeps passes. a frame that would need more than maxStepsPerFrame steps
+	// (a breakpoint, a hitch) drops the rest instead of making the next frame slower still
+	float fixedStep = 1.0f / 60;
+	int substeps = 1;
+	int maxStepsPerFrame = 5;
+	float accumulator = 0; // time not simulated yet, always under fixedStep after advance()
+	int lastSteps = 0; // steps the last advance() took
+	float droppedTime = 0; // seconds thrown away by the clamp, in total
+
+	// lockstep and replay checking: pairs are always sorted (the tree and brute force hand them
+	// out in whatever order they were built in otherwise) and every update() ends by hashing
+	// the bodies into frameHash. nothing else changes, the narrow phase, islands, solver and
+	// integrator (scalar and simd alike) already give the same bits on any number of threads
+	bool deterministic = false;
+	unsigned int frameHash = 0; // stateHash() after the last update(), when deterministic
+	int hashGrain = 4096; // bodies per chunk hashed on its own, see stateHash()
+
+	Rectangle bounds = { 0, 0, 1200, 800 };
+	FizziksBoundsPolicy boundsPolicy = BOUNDS_NONE; // half-spaces and static objekts are left alone
+
+	// lines for the game to draw afterwards, see FizziksDebugDraw. every category is off to start with
+	FizziksDebugDraw debugDraw;
+	std::vector<Rectangle> debugBounds; // scratch for the broad phase category
+
+	FizziksBroadphaseMode broadphaseMode = BROADPHASE_SPATIAL_HASH;
+	FizziksSpatialHash spatialHash;
+	FizziksSweepAndPrune sweepAndPrune;
+	FizziksAABBTree tree; // always kept up to date so game code can query it
+	std::vector<FizziksPair> pairs;
+	std::vector<int> alwaysTest; // half-spaces, tested against everything
+	std::vector<int> queryResults;
+	std::vector<FizziksPair> shapePairs[SHAPE_COUNT][SHAPE_COUNT]; // pairs bucketed by shape, in each kernel's argument order
+	std::vector<unsigned char> colliding; // per objekt, touched anything last step
+
+	FizziksSolverMode solverMode = SOLVER_SEQUENTIAL_IMPULSE;
+	FizziksContactSolver solver; // iterations etc. are set on here
+	FizziksIslands islands; // sleeping, on by default
+
+	// objekts flagged setBullet() are swept from where they started each step to where they
+	// ended up. the first thing in the way stops them there and takes the bounce
+	bool continuousCollision = true;
+	int bulletHits = 0; // last step
+	std::vector<int> bullets; // this step's, by index
+	std::vector<Vector2> bulletStarts;
+
+	// how long each stage of update() took, for the last few hundred steps
+	FizziksProfiler profiler;
+
+	// detection, grid cells, islands and integration are all handed out on these
+	FizziksThreadPool threads;
+	int detectGrain = 256; // pairs per chunk handed to a thread
+	int integrateGrain = 4096; // bodies per chunk, keep it a multiple of 8 so only the last chunk has a scalar tail
+	std::vector<FizziksContact> contacts; // last step's, grouped by kernel and in pair order within each
+
+	// scratch for the detection threads: a contact buffer per thread, and for each chunk
+	// of pairs which thread's buffer its contacts ended up in
+	struct ContactChunk {
+		int worker;
+		int begin;
+		int count;
+	};
+	std::vector<std::vector<FizziksContact>> workerContacts;
+	std::vector<ContactChunk> contactChunks;
+	int candidatePairs = 0; // pairs handed to the narrow phase last step
+
+	// objekts made here come out of the world's pools and are already added
+	FizziksCircle* createCircle();
+	FizziksAABB* createAABB();
+	FizziksHalfspace* createHalfspace();
+
+	void add(FizziksObjekt* newObject);
+
+	// takes the objekt out of the world without deleting it. O(1), the last objekt
+	// takes its place, so a loop removing as it goes has to look at index again
+	void remove(int index);
+
+	// remove(), then hands pooled objekts back to their pool. anything that wasn't made
+	// by a create function belongs to whoever made it and is left alone
+	void destroy(int index);
+
+	// marks the objekt to be destroyed by the next flushDestroyed(). it stays where it is
+	// (and keeps colliding) until then, so indices don't shift in the middle of a step
+	void kill(int index);
+	// destroys everything killed since the last flush in one pass, keeping everyone else's order.
+	// update() calls it at the end of every step
+	void flushDestroyed();
+
+	// brings every leaf of the tree up to date with where its objekt is now
+	void syncTree();
+
+	// topmost objekt under the point, or nullptr. half-spaces are never picked
+	FizziksObjekt* queryPoint(Vector2 point);
+
+	void queryRect(Rectangle rect, std::vector<FizziksObjekt*>& found);
+
+	// first objekt the segment from -> to hits, or nullptr. hitPoint is where
+	FizziksObjekt* raycast(Vector2 from, Vector2 to, Vector2* hitPoint);
+
+	void resetNetForces();
+
+	void addGravityForces();
+
+	void applyKinematics();
+
+	// either side of applyKinematics(): note where every bullet starts, then pull back any
+	// that went through something on the way
+	void rememberBullets();
+	void sweepBullets();
+
+	void applyBounds();
+
+	// one step of deltaTime, in substeps passes
+	void update(float deltaTime);
+
+	// bounds and broad phase lines for debugDraw, update() calls it after the last substep
+	void recordDebugShapes();
+
+	// crc32 of every body's position, velocity and flags. each hashGrain bodies are hashed on
+	// whichever thread gets them and the chunk hashes hashed in order, so the result only
+	// depends on the bodies, never on the thread count
+	unsigned int stateHash();
+
+	// the frame took frameTime, catch the world up in fixed steps. returns how many it took
+	int advance(float frameTime);
+	// how far from the second last step to the last one to draw things, see getInterpolatedPosition()
+	float interpolation() const { return fixedStep > 0 ? accumulator / fixedStep : 1; }
+
+	void checkCollisions();
+
+	// broad phase: fills pairs with everything whose bounds touch, plus every half-space against everything else
+	void findPairs();
+
+	// narrow phase for one pair, returns true if they overlap
+	bool testPair(FizziksObjekt* objektPointerA, FizziksObjekt* objektPointerB);
+
+private:
+	void recycle(FizziksObjekt* objekt);
+	void substep(float deltaTime);
+
+	int killed = 0;
+	std::vector<unsigned int> chunkHashes; // stateHash()'s, columns per chunk in order
+	FizziksPool<FizziksCircle> circlePool;
+	FizziksPool<FizziksAABB> aabbPool;
+	FizziksPool<FizziksHalfspace> halfspacePool;
+};
+
+
+const char* BroadphaseModeName(FizziksBroadphaseMode mode);
+const char* SolverModeName(FizziksSolverMode mode);
+
+// the same crc32 as raylib's ComputeCRC32, here so the physics doesn't need raylib linked in
+unsigned int FizziksCRC32(const unsigned char* data, int dataSize);
@@ -0,0 +1,43 @@
+#pragma once
+
+// one per-instance vertex attribute, read from the instance struct at offset
+struct FizziksInstanceAttribute {
+	int components;
+	int type; // RL_FLOAT, RL_UNSIGNED_BYTE...
+	bool normalized;
+	int offset;
+};
+
+// a quad drawn once per instance in a single call, what the game's renderers are built on.
+// the shader gets the quad's corner at location 0 and the instance's attributes at 1, 2...
+// and an mvp uniform. the instance buffer grows to fit, it's never shrunk. needs gl 3.3, load()
+// says false otherwise and the renderer falls back to raylib's shapes
+class FizziksInstancedQuads {
+public:
+	FizziksInstancedQuads() = default;
+	FizziksInstancedQuads(const FizziksInstancedQuads&) = delete;
+	FizziksInstancedQuads& operator=(const FizziksInstancedQuads&) = delete;
+
+	// corners is the quad as two triangles, six x y pairs
+	bool load(const char* vertexShader, const char* fragmentShader, const float corners[12],
+		int stride, const FizziksInstanceAttribute* attributes, int attributeCount);
+	void unload();
+	bool isLoaded() const { return shader != 0; }
+
+	// flushes rlgl's batch so everything drawn before stays underneath, then uploads count
+	// instances of stride bytes each and draws them all at once
+	void draw(const void* instances, int count);
+
+private:
+	void reserve(int count);
+
+	unsigned int shader = 0;
+	int mvpLocation = -1;
+	unsigned int vertexArray = 0;
+	unsigned int cornerBuffer = 0;
+	unsigned int instanceBuffer = 0;
+	int capacity = 0;
+	int stride = 0;
+	FizziksInstanceAttribute attributes[8] = {};
+	int attributeCount = 0;
+};
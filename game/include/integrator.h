@@ -0,0 +1,24 @@
+#pragma once
+
+#include "raylib.h"
+#include "bodies.h"
+
+enum FizziksSimdLevel {
+	SIMD_SCALAR,
+	SIMD_SSE2, // 4 bodies per instruction
+	SIMD_AVX2 // 8 bodies per instruction
+};
+
+// best level this cpu (and build) supports, checked once
+FizziksSimdLevel FizziksBestSimdLevel();
+const char* FizziksSimdLevelName(FizziksSimdLevel level);
+
+// force += gravity * mass on every body that isn't static or asleep
+void FizziksAddGravity(FizziksBodies& bodies, Vector2 accelerationGravity, FizziksSimdLevel level);
+// the same over bodies [begin, end) only, so the range can be split between threads
+void FizziksAddGravity(FizziksBodies& bodies, Vector2 accelerationGravity, FizziksSimdLevel level, int begin, int end);
+
+// position += velocity * dt, then velocity += force * inverseMass * dt, on every body that isn't static or asleep.
+// those are masked out rather than branched around, every level gives bit-identical results
+void FizziksIntegrate(FizziksBodies& bodies, float dt, FizziksSimdLevel level);
+void FizziksIntegrate(FizziksBodies& bodies, float dt, FizziksSimdLevel level, int begin, int end);
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "bodies.h"
+#include "solver.h"
+#include <vector>
+
+// groups of moving bodies joined up by touching each other. static bodies don't join anything,
+// otherwise everything resting on the floor would be one island. islands share no moving body so
+// the solver can work on them in parallel. an island goes to sleep once every body in it has been
+// slow for long enough, and wakes as soon as any of it has to move. sleeping bodies aren't
+// integrated, pulled by gravity or handed to the narrow phase.
+class FizziksIslands {
+public:
+	bool allowSleep = true;
+	float sleepSpeed = 5; // px/s, slower than this counts as still
+	float timeToSleep = 0.5f; // seconds an island has to stay still before it sleeps
+
+	// before the solver: joins up this step's contacts (plus the ones between sleeping bodies
+	// from before) into islands and sorts the contacts by island
+	void build(const std::vector<FizziksContact>& contacts, const FizziksBodies& bodies);
+	// after the solver, before integrating: sleeps or wakes each island as a whole
+	void updateSleep(const std::vector<FizziksContact>& contacts, FizziksBodies& bodies, float dt);
+
+	// wakes whatever was sleeping against this body, for when it's taken out from under them
+	void wakeTouching(int index, FizziksBodies& bodies);
+	// same for every body flagged BODY_DEAD, in one go
+	void wakeTouchingDead(FizziksBodies& bodies);
+	void wakeAll(FizziksBodies& bodies);
+
+	// sleeping pairs by body index, a then b, for snapshots. same caveat as the solver's warm start
+	void saveSleepingPairs(const FizziksBodies& bodies, std::vector<int>& saved) const;
+	void loadSleepingPairs(const std::vector<int>& saved, const FizziksBodies& bodies);
+
+	int islandCount() const { return islandBegin.empty() ? 0 : (int)islandBegin.size() - 1; }
+	int sleepingCount() const { return sleeping; }
+
+	// bodies in island k, by index, are members[islandBegin[k]] .. members[islandBegin[k + 1] - 1]
+	std::vector<int> members;
+	std::vector<int> islandBegin;
+
+	// the same for contacts, by index into the contact list build() was given
+	std::vector<int> contactOrder;
+	std::vector<int> contactBegin;
+
+	// islands that have any contacts, the most contacts first, so whoever starts on
+	// the biggest one isn't still going long after everyone else has finished
+	std::vector<int> solveOrder;
+
+private:
+	int find(int body);
+	void join(int a, int b);
+
+	// sleeping pairs aren't looked at by the narrow phase, so their contacts are
+	// remembered here to keep a sleeping stack one island
+	struct SleepingPair {
+		FizziksBodyHandle a;
+		FizziksBodyHandle b;
+	};
+
+	std::vector<SleepingPair> sleepingPairs;
+	std::vector<SleepingPair> nextSleepingPairs;
+	std::vector<int> parent; // union-find, per body
+	std::vector<int> islandOf; // per body, or -1 for static ones
+	std::vector<int> cursor;
+	int sleeping = 0;
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+
+// a whole file mapped read only (mmap, or MapViewOfFile on windows), so nothing is read off
+// disk until it's touched and nothing is copied on the way. kept out of anything that
+// includes raylib, windows.h and raylib.h can't be in the same file
+class FizziksMappedFile {
+public:
+	FizziksMappedFile() = default;
+	FizziksMappedFile(const FizziksMappedFile&) = delete;
+	FizziksMappedFile& operator=(const FizziksMappedFile&) = delete;
+	~FizziksMappedFile() { close(); }
+
+	// false if it can't be opened or is empty
+	bool open(const char* path);
+	void close();
+
+	const unsigned char* data() const { return bytes; }
+	size_t size() const { return length; }
+
+private:
+	const unsigned char* bytes = nullptr;
+	size_t length = 0;
+#ifdef _WIN32
+	void* file = nullptr;
+	void* mapping = nullptr;
+#endif
+};
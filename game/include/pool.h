@@ -0,0 +1,69 @@
+#pragma once
+
+#include <new>
+#include <vector>
+
+// hands out T's from blocks of BlockSize with a free list threaded through the unused
+// slots. blocks are never moved or freed while the pool is alive, so pointers stay good,
+// and once the pool has grown to the busiest frame spawning never touches the heap.
+template <typename T, int BlockSize = 256>
+class FizziksPool {
+public:
+	FizziksPool() = default;
+	FizziksPool(const FizziksPool&) = delete;
+	FizziksPool& operator=(const FizziksPool&) = delete;
+
+	~FizziksPool() {
+		for (Slot* block : blocks) {
+			for (int i = 0; i < BlockSize; i++) {
+				if (block[i].alive) ((T*)block[i].storage)->~T();
+			}
+			delete[] block;
+		}
+	}
+
+	T* create() {
+		if (freeList == nullptr) grow();
+
+		Slot* slot = freeList;
+		freeList = slot->next;
+		slot->alive = true;
+		live++;
+		return new (slot->storage) T();
+	}
+
+	// object has to have come from this pool's create()
+	void destroy(T* object) {
+		Slot* slot = (Slot*)object; // storage is the first member
+		object->~T();
+		slot->alive = false;
+		slot->next = freeList;
+		freeList = slot;
+		live--;
+	}
+
+	int liveCount() const { return live; }
+	int capacity() const { return (int)blocks.size() * BlockSize; }
+
+private:
+	struct Slot {
+		alignas(T) unsigned char storage[sizeof(T)];
+		Slot* next = nullptr;
+		bool alive = false;
+	};
+
+	void grow() {
+		Slot* block = new Slot[BlockSize];
+		blocks.push_back(block);
+
+		// hand them out in address order
+		for (int i = BlockSize - 1; i >= 0; i--) {
+			block[i].next = freeList;
+			freeList = &block[i];
+		}
+	}
+
+	std::vector<Slot*> blocks;
+	Slot* freeList = nullptr;
+	int live = 0;
+};
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <vector>
+
+// building with FIZZIKS_PROFILE defined to 0 turns every FIZZIKS_PROFILE_ macro below into
+// nothing, so the stages cost nothing at all. the profiler is still there, it just never hears anything
+#ifndef FIZZIKS_PROFILE
+#define FIZZIKS_PROFILE 1
+#endif
+
+// the parts of FizziksWorld::update timed on their own. indented ones happen inside the one above
+enum FizziksProfileStage {
+	PROFILE_UPDATE,
+	PROFILE_RESET_FORCES,
+	PROFILE_GRAVITY,
+	PROFILE_COLLISIONS,
+	PROFILE_BROADPHASE,
+	PROFILE_NARROWPHASE,
+	PROFILE_SOLVER,
+	PROFILE_SLEEP,
+	PROFILE_BULLETS, // rememberBullets and sweepBullets together
+	PROFILE_KINEMATICS,
+	PROFILE_CLEANUP, // applyBounds and flushDestroyed
+	PROFILE_HASH,
+	PROFILE_STAGE_COUNT
+};
+
+enum FizziksProfileCounter {
+	PROFILE_PAIR_TESTS, // pairs the narrow phase looked at
+	PROFILE_CONTACTS,
+	PROFILE_ACTIVE_BODIES, // bodies not asleep at the end of the step
+	PROFILE_COUNTER_COUNT
+};
+
+const char* FizziksProfileStageName(FizziksProfileStage stage);
+// 0 for PROFILE_UPDATE, 1 for the stages directly inside it, 2 for the ones inside checkCollisions
+int FizziksProfileStageDepth(FizziksProfileStage stage);
+const char* FizziksProfileCounterName(FizziksProfileCounter counter);
+
+struct FizziksProfileEvent {
+	FizziksProfileStage stage;
+	double start; // seconds since the profiler was made
+	double duration;
+};
+
+// one update(). stages that run every substep are added up
+struct FizziksProfileFrame {
+	double start;
+	double stageSeconds[PROFILE_STAGE_COUNT];
+	int counters[PROFILE_COUNTER_COUNT];
+	std::vector<FizziksProfileEvent> events; // every stage in the order it finished, for the trace
+};
+
+// keeps the last historyLength() frames. only the thread calling update() talks to it
+class FizziksProfiler {
+public:
+	FizziksProfiler();
+
+	bool enabled = true; // off stops the clock being read at all, and no frames are kept
+
+	void setHistoryLength(int frames);
+	int historyLength() const { return (int)frames.size(); }
+
+	void beginFrame();
+	void endFrame();
+	double now() const;
+	void record(FizziksProfileStage stage, double start, double end);
+	void count(FizziksProfileCounter counter, int value);
+
+	// frames kept so far, and one of them: 0 is the newest finished, 1 the one before it...
+	int frameCount() const { return stored; }
+	const FizziksProfileFrame& frame(int ago) const;
+
+	// over every frame since the last clear(), not just the history
+	long long totalFrames() const { return total; }
+	double averageSeconds(FizziksProfileStage stage) const { return total > 0 ? totalSeconds[stage] / total : 0; }
+	double averageCount(FizziksProfileCounter counter) const { return total > 0 ? (double)totalCounts[counter] / total : 0; }
+
+	// the history as chrome://tracing / perfetto json, every stage a slice and the counters as tracks
+	bool writeChromeTrace(const char* path) const;
+	void clear();
+
+private:
+	std::vector<FizziksProfileFrame> frames; // a ring, newest is the last one begun
+	int newest = -1;
+	int stored = 0;
+	bool inFrame = false;
+
+	long long total = 0;
+	double totalSeconds[PROFILE_STAGE_COUNT] = {};
+	long long totalCounts[PROFILE_COUNTER_COUNT] = {};
+};
+
+// times from construction to destruction as one stage
+class FizziksProfileScope {
+public:
+	FizziksProfileScope(FizziksProfiler& profiler, FizziksProfileStage stage)
+		: profiler(profiler), stage(stage), start(profiler.enabled ? profiler.now() : -1) {}
+	~FizziksProfileScope() { if (start >= 0) profiler.record(stage, start, profiler.now()); }
+
+private:
+	FizziksProfiler& profiler;
+	FizziksProfileStage stage;
+	double start;
+};
+
+// a whole frame, PROFILE_UPDATE around everything else. scopes inside it finish first so they land in it
+class FizziksProfileFrameScope {
+public:
+	explicit FizziksProfileFrameScope(FizziksProfiler& profiler) : profiler(profiler) {
+		profiler.beginFrame();
+		start = profiler.enabled ? profiler.now() : -1;
+	}
+	~FizziksProfileFrameScope() {
+		if (start >= 0) profiler.record(PROFILE_UPDATE, start, profiler.now());
+		profiler.endFrame();
+	}
+
+private:
+	FizziksProfiler& profiler;
+	double start;
+};
+
+#if FIZZIKS_PROFILE
+#define FIZZIKS_PROFILE_JOIN2(a, b) a##b
+#define FIZZIKS_PROFILE_JOIN(a, b) FIZZIKS_PROFILE_JOIN2(a, b)
+#define FIZZIKS_PROFILE_FRAME(profiler) FizziksProfileFrameScope FIZZIKS_PROFILE_JOIN(profileFrame, __LINE__)(profiler)
+#define FIZZIKS_PROFILE_SCOPE(profiler, stage) FizziksProfileScope FIZZIKS_PROFILE_JOIN(profileScope, __LINE__)(profiler, stage)
+#define FIZZIKS_PROFILE_COUNT(profiler, counter, value) (profiler).count(counter, value)
+#else
+#define FIZZIKS_PROFILE_FRAME(profiler)
+#define FIZZIKS_PROFILE_SCOPE(profiler, stage)
+#define FIZZIKS_PROFILE_COUNT(profiler, counter, value)
+#endif
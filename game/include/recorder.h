@@ -0,0 +1,123 @@
+#pragma once
+
+#include "fizziks.h"
+#include "mappedfile.h"
+#include <vector>
+
+// .fztraj files: every body's position and velocity for every recorded frame, for looking at a
+// run afterwards. frames are gathered into chunks, each chunk deflated on its own, so any frame
+// can be read back by inflating just the one chunk it's in.
+//
+//   FizziksTrajectoryHeader
+//   chunk, chunk, ...          FizziksTrajectoryChunk then compressedSize bytes of deflate
+//   index                      FizziksTrajectoryIndexEntry[chunkCount]
+//   FizziksTrajectoryFooter
+//
+// inflated, a chunk is its frames one after another, each a body count followed by position x,
+// position y, velocity x and velocity y as float[bodyCount] each. a frame with the same body count
+// as the one before it in the chunk has its floats' bits xor'd with that frame's, and every array
+// is then stored as byte planes (all the lowest bytes, then all the second bytes...), which is
+// what makes them compress. a file that never got its index (the run crashed) can still be read, the
+// reader walks the chunk headers instead
+const unsigned int FIZZIKS_TRAJECTORY_VERSION = 1;
+
+struct FizziksTrajectoryHeader {
+	char magic[4]; // "FZTR"
+	unsigned int version;
+	unsigned int framesPerChunk;
+	unsigned int reserved;
+};
+
+struct FizziksTrajectoryChunk {
+	unsigned int firstFrame;
+	unsigned int frameCount;
+	unsigned int rawSize;
+	unsigned int compressedSize;
+};
+
+struct FizziksTrajectoryIndexEntry {
+	unsigned long long offset; // of the chunk's FizziksTrajectoryChunk from the start of the file
+	unsigned int firstFrame;
+	unsigned int frameCount;
+};
+
+struct FizziksTrajectoryFooter {
+	unsigned long long indexOffset;
+	unsigned int chunkCount;
+	unsigned int frameCount;
+	char magic[4]; // "FZTE"
+	unsigned int padding;
+};
+
+// writes a .fztraj while the world runs. record() only copies the body arrays into the chunk being
+// filled; full chunks go to a background thread that deflates and writes them, so the step never
+// waits on compression or the disk unless that thread is a whole chunk behind
+class FizziksTrajectoryRecorder {
+public:
+	int framesPerChunk = 60; // set before open()
+	int compressionLevel = 5; // sdefl's 0 (fastest) to 8 (smallest)
+
+	FizziksTrajectoryRecorder() = default;
+	FizziksTrajectoryRecorder(const FizziksTrajectoryRecorder&) = delete;
+	FizziksTrajectoryRecorder& operator=(const FizziksTrajectoryRecorder&) = delete;
+	~FizziksTrajectoryRecorder() { close(); }
+
+	bool open(const char* path);
+	void record(const FizziksWorld& world);
+	// writes the last part-filled chunk and the index. false if anything failed to write
+	bool close();
+
+	bool isOpen() const { return state != nullptr; }
+	int frameCount() const { return frames; }
+	// raw frame bytes recorded so far, and what they've come to on disk
+	unsigned long long rawBytes() const { return raw; }
+	unsigned long long bytesWritten() const;
+
+private:
+	void submit();
+
+	struct State; // the file, the thread and the buffers it hands over, kept out of this header
+	State* state = nullptr;
+	int frames = 0;
+	unsigned long long raw = 0;
+};
+
+// one frame of a trajectory file
+struct FizziksTrajectoryFrame {
+	std::vector<float> positionX;
+	std::vector<float> positionY;
+	std::vector<float> velocityX;
+	std::vector<float> velocityY;
+};
+
+// reads frames back out of a .fztraj in any order. the last chunk inflated is kept, so stepping
+// through frames in order inflates each chunk once
+class FizziksTrajectoryReader {
+public:
+	FizziksTrajectoryReader() = default;
+	FizziksTrajectoryReader(const FizziksTrajectoryReader&) = delete;
+	FizziksTrajectoryReader& operator=(const FizziksTrajectoryReader&) = delete;
+	~FizziksTrajectoryReader() { close(); }
+
+	// false if it isn't a trajectory file this can read
+	bool open(const char* path);
+	void close();
+
+	int frameCount() const { return frames; }
+	int chunkCount() const { return (int)index.size(); }
+
+	// false if frame is out of range or its chunk is damaged
+	bool readFrame(int frame, FizziksTrajectoryFrame& out);
+
+private:
+	bool loadChunk(int chunk);
+
+	FizziksMappedFile file;
+	std::vector<FizziksTrajectoryIndexEntry> index;
+	int frames = 0;
+
+	int cachedChunk = -1;
+	std::vector<unsigned char> chunkData; // the cached chunk inflated, xor undone
+	std::vector<size_t> frameOffsets; // where each of its frames starts in chunkData
+	std::vector<unsigned char> scratch;
+};
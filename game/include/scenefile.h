@@ -0,0 +1,56 @@
+#pragma once
+
+#include "fizziks.h"
+
+// .fzscene files: a level laid out the way FizziksBodies keeps it, so loading one is a memcpy
+// per body array out of the mapped file instead of building every objekt in code.
+//
+//   FizziksSceneHeader
+//   position x, position y, velocity x, velocity y, mass, inverse mass   float[objektCount] each
+//   flags                                                                unsigned char[objektCount]
+//   shape table                                                          FizziksSceneShape[objektCount]
+//
+// little endian, every section starts on a SCENE_ALIGNMENT boundary and is found through the
+// header's offsets, so sections can be added later without moving the old ones
+const unsigned int FIZZIKS_SCENE_VERSION = 1;
+const int SCENE_ALIGNMENT = 16;
+
+enum FizziksSceneSection {
+	SCENE_POSITION_X,
+	SCENE_POSITION_Y,
+	SCENE_VELOCITY_X,
+	SCENE_VELOCITY_Y,
+	SCENE_MASS,
+	SCENE_INVERSE_MASS,
+	SCENE_FLAGS,
+	SCENE_SHAPES,
+	SCENE_SECTION_COUNT
+};
+
+struct FizziksSceneHeader {
+	char magic[4]; // "FZSC"
+	unsigned int version;
+	unsigned int headerSize; // sizeof(FizziksSceneHeader) when it was written
+	unsigned int objektCount;
+	float gravityX;
+	float gravityY;
+	unsigned long long sections[SCENE_SECTION_COUNT]; // byte offsets from the start of the file
+};
+
+// what the objekt itself holds rather than its body, one per objekt in the same order
+struct FizziksSceneShape {
+	unsigned char shape; // FizziksShape
+	unsigned char padding[3];
+	unsigned int color; // r g b a, lowest byte first. the objekt's base colour
+	float parameterA; // radius, box width or half-space rotation in degrees
+	float parameterB; // box height
+	float bounciness;
+	float grippiness;
+};
+
+// every objekt in the world. sleeping and dead flags aren't kept, everything loads awake
+bool FizziksSaveScene(const FizziksWorld& world, const char* path);
+
+// adds the file's objekts to the world after whatever is already in it, made from the world's
+// pools, and sets gravity. false (with the world untouched) if the file isn't a scene this can read
+bool FizziksLoadScene(FizziksWorld& world, const char* path);
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "fizziks.h"
+
+enum FizziksScene {
+	SCENE_SLINGSHOT, // the towers the game starts with
+	SCENE_CIRCLE_PILE,
+	SCENE_AABB_TOWER,
+	SCENE_MIXED_RAIN
+};
+
+const char* FizziksSceneName(FizziksScene scene);
+// false if name isn't one of the scene names
+bool FizziksSceneFromName(const char* name, FizziksScene* scene);
+
+// the game's towers and pigs, all made from the world's pools
+void MakeDeleteableObjekts(FizziksWorld& world);
+
+// fills the world with roughly count objekts. the same scene, count and seed always
+// give exactly the same world so runs can be compared
+void MakeScene(FizziksWorld& world, FizziksScene scene, int count, unsigned int seed = 1);
+
+// destroys every objekt in the world
+void DestroyObjekts(FizziksWorld& world);
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "fizziks.h"
+#include <vector>
+
+// a world flattened to 32-bit words: gravity and the frame accumulator, then for every objekt its
+// shape, body flags, position, velocity, force, mass, still timer, bounciness, grippiness, colours
+// and shape parameters (radius, box size or half-space rotation, the normal follows from that),
+// then the solver's warm start impulses and the islands' sleeping pairs. that's everything a step
+// reads, so stepping on from a restore gives exactly what stepping on from the capture did (with
+// the grid or sweep and prune broad phase, the tree hands out pairs in the order it was built in).
+// floats are stored as their bits and every column is one word per objekt, so two states a step
+// apart mostly differ in the low bits of the same words
+typedef std::vector<unsigned int> FizziksWorldState;
+
+void FizziksCaptureState(const FizziksWorld& world, FizziksWorldState& state);
+
+// fast when the world still has the same shapes in the same order, it only overwrites the body
+// arrays. otherwise objekts from the first one that differs on are destroyed and made again from
+// the world's pools. false (and the world left alone) if state isn't something capture wrote
+bool FizziksRestoreState(FizziksWorld& world, const FizziksWorldState& state);
+
+// a snapshot blob on its own (base null), or as the difference from base: every word is xor'd
+// with the word in the same place in base, then written as a varint with runs of zeros folded
+// into one. words that didn't change cost nothing and ones that barely did cost a byte or two
+void FizziksEncodeSnapshot(const FizziksWorldState& state, const FizziksWorldState* base, std::vector<unsigned char>& blob);
+// base has to be the state the blob was encoded against. false if the blob is damaged or needs a base it wasn't given
+bool FizziksDecodeSnapshot(const unsigned char* blob, int size, const FizziksWorldState* base, FizziksWorldState& state);
+
+// one snapshot per step for rewinding. every keyInterval'th is stored whole and the rest as
+// deltas from the one before, so restoring decodes at most keyInterval blobs
+class FizziksSnapshotHistory {
+public:
+	int keyInterval = 120; // set before recording anything
+	int capacity = 0; // most snapshots kept, 0 keeps everything
+
+	// returns how many of the oldest snapshots it dropped to stay within capacity, a whole key interval at a time
+	int record(const FizziksWorld& world);
+	// puts the world back to snapshot index and forgets everything recorded after it
+	bool restore(FizziksWorld& world, int index);
+	void clear();
+
+	int count() const { return (int)offsets.size(); }
+	size_t bytes() const { return data.size(); }
+
+private:
+	bool decode(int index, FizziksWorldState& state, FizziksWorldState& scratch) const;
+	void truncate(int newCount);
+	void dropOldest(int dropCount);
+
+	std::vector<unsigned char> data; // every blob end to end
+	std::vector<size_t> offsets; // where each one starts in data
+	FizziksWorldState last; // what the newest blob decodes to, the base for the next delta
+	FizziksWorldState current;
+	FizziksWorldState scratch;
+	std::vector<unsigned char> blob;
+};
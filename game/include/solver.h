@@ -0,0 +1,80 @@
+#pragma once
+
+#include "raylib.h"
+#include "bodies.h"
+#include "threadpool.h"
+#include <vector>
+
+class FizziksIslands;
+
+// what the solver needs to know about one touching pair. the narrow phase fills in
+// everything down to points, the world adds friction and restitution from the two objekts
+struct FizziksContact {
+	int a = -1; // objekt (and body) indices, in the order the kernel takes them
+	int b = -1;
+	Vector2 normal = { 0, 0 }; // unit, from a towards b
+	float depth = 0; // how far they overlap along normal
+	int pointCount = 0;
+	Vector2 points[2];
+
+	float friction = 0;
+	float restitution = 0;
+
+	// accumulated over the solver iterations, and carried over to next step's contact
+	// between the same two bodies to start from
+	float normalImpulse = 0;
+	float tangentImpulse = 0;
+};
+
+// sequential impulses: every iteration walks the contacts in order and nudges each one's
+// accumulated impulse towards what would stop the bodies closing (normal) and sliding
+// (tangent, capped by friction). bodies don't rotate, so each contact is one normal row and
+// one friction row no matter how many points it has.
+class FizziksContactSolver {
+public:
+	int iterations = 8;
+	float baumgarte = 0.2f; // fraction of the overlap pushed out per step
+	float slop = 0.5f; // pixels of overlap left alone so resting contacts don't jitter
+	float restitutionThreshold = 40; // closing speed in px/s below which nothing bounces
+	bool warmStarting = true;
+
+	// changes bodies' velocities only, positions follow when the world integrates. islands share
+	// no moving body, so each is solved start to finish by whichever worker picks it up and the
+	// result is the same however many threads there are
+	void solve(std::vector<FizziksContact>& contacts, const FizziksIslands& islands, FizziksBodies& bodies, float dt, FizziksThreadPool& threads);
+
+	// contacts that found an impulse from the step before, last solve
+	int warmStarted() const { return warmStartCount; }
+
+	// last step's impulses by body index (a, b, normal and the two impulses), for snapshots.
+	// loading only makes sense into the same bodies they were saved from
+	void saveWarmStart(const FizziksBodies& bodies, std::vector<FizziksContact>& saved) const;
+	void loadWarmStart(const std::vector<FizziksContact>& saved, const FizziksBodies& bodies);
+
+private:
+	struct Row {
+		float mass; // 1 / (inverse mass a + inverse mass b), the same along normal and tangent since nothing rotates
+		float bias; // velocity the normal row aims for, restitution or overlap push out
+		float inverseMassA;
+		float inverseMassB;
+		bool warmStarted;
+	};
+
+	void prepare(FizziksContact& contact, Row& row, const FizziksBodies& bodies, float inverseDt);
+	void solveIsland(std::vector<FizziksContact>& contacts, const int* order, int count, FizziksBodies& bodies);
+
+	// last step's impulses, sorted by key so lookups are a binary search
+	struct CachedImpulse {
+		unsigned long long key;
+		FizziksBodyHandle bodyA;
+		FizziksBodyHandle bodyB;
+		Vector2 normal;
+		float normalImpulse;
+		float tangentImpulse;
+	};
+
+	std::vector<Row> rows;
+	std::vector<CachedImpulse> cache;
+	std::vector<CachedImpulse> nextCache;
+	int warmStartCount = 0;
+};
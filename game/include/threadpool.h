@@ -0,0 +1,36 @@
+#pragma once
+
+#include <functional>
+
+// a handful of threads that sleep until run() hands them tasks. every worker has its own queue,
+// takes from the front of it, and steals from the back of someone else's once it runs dry.
+// the thread calling run() works through tasks too and is always worker 0.
+class FizziksThreadPool {
+public:
+	FizziksThreadPool() = default;
+	FizziksThreadPool(const FizziksThreadPool&) = delete;
+	FizziksThreadPool& operator=(const FizziksThreadPool&) = delete;
+	~FizziksThreadPool();
+
+	// 1 (the default) runs everything on the calling thread, 0 means one per core
+	void setThreadCount(int count);
+	int threadCount() const { return threads; }
+
+	// calls job(task, worker) for every task in [0, count), then waits for all of them. tasks are
+	// dealt round the queues in order, so whatever should start first (the biggest) goes first.
+	// worker is in [0, threadCount()) and no two tasks run on the same worker at once,
+	// so it can index per-thread scratch space without locking
+	void run(int count, const std::function<void(int task, int worker)>& job);
+
+	// run() over [0, count) in chunks of grain, job gets each chunk's range
+	void parallelFor(int count, int grain, const std::function<void(int begin, int end, int worker)>& job);
+
+	// tasks that ended up on a different worker than they were dealt to, last run()
+	int stolen() const { return stolenCount; }
+
+private:
+	struct State; // the threads, locks and current job, kept out of this header
+	State* state = nullptr;
+	int threads = 1;
+	int stolenCount = 0;
+};
@@ -0,0 +1,349 @@
+#include "aabbtree.h"
+#include <algorithm>
+#include <cmath>
+
+FizziksAABBTree::Box FizziksAABBTree::toBox(Rectangle r) {
+	return { r.x, r.y, r.x + r.width, r.y + r.height };
+}
+
+FizziksAABBTree::Box FizziksAABBTree::combine(const Box& a, const Box& b) {
+	return { fminf(a.minX, b.minX), fminf(a.minY, b.minY), fmaxf(a.maxX, b.maxX), fmaxf(a.maxY, b.maxY) };
+}
+
+bool FizziksAABBTree::contains(const Box& outer, const Box& inner) {
+	return outer.minX <= inner.minX && outer.minY <= inner.minY
+		&& inner.maxX <= outer.maxX && inner.maxY <= outer.maxY;
+}
+
+bool FizziksAABBTree::overlaps(const Box& a, const Box& b) {
+	return a.minX <= b.maxX && b.minX <= a.maxX && a.minY <= b.maxY && b.minY <= a.maxY;
+}
+
+// perimeter stands in for surface area as the insertion cost in 2D
+float FizziksAABBTree::perimeter(const Box& b) {
+	return 2.0f * ((b.maxX - b.minX) + (b.maxY - b.minY));
+}
+
+Rectangle FizziksAABBTree::fatBounds(int proxy) const {
+	const Box& b = nodes[proxy].fat;
+	return { b.minX, b.minY, b.maxX - b.minX, b.maxY - b.minY };
+}
+
+void FizziksAABBTree::nodeBounds(std::vector<Rectangle>& bounds) const {
+	for (int n = 0; n < nodes.size(); n++) {
+		if (nodes[n].height >= 0) bounds.push_back(fatBounds(n));
+	}
+}
+
+int FizziksAABBTree::allocateNode() {
+	int id;
+	if (freeList >= 0) {
+		id = freeList;
+		freeList = nodes[id].parent;
+	}
+	else {
+		id = (int)nodes.size();
+		nodes.push_back(Node());
+	}
+
+	nodes[id] = Node();
+	nodes[id].height = 0;
+	return id;
+}
+
+void FizziksAABBTree::freeNode(int node) {
+	nodes[node].parent = freeList;
+	nodes[node].height = -1;
+	freeList = node;
+}
+
+int FizziksAABBTree::insert(int index, Rectangle bounds) {
+	int proxy = allocateNode();
+	Box tight = toBox(bounds);
+
+	nodes[proxy].tight = tight;
+	nodes[proxy].fat = { tight.minX - margin, tight.minY - margin, tight.maxX + margin, tight.maxY + margin };
+	nodes[proxy].index = index;
+
+	insertLeaf(proxy);
+	leaves++;
+	return proxy;
+}
+
+void FizziksAABBTree::remove(int proxy) {
+	removeLeaf(proxy);
+	freeNode(proxy);
+	leaves--;
+}
+
+bool FizziksAABBTree::move(int proxy, int index, Rectangle bounds, Vector2 displacement) {
+	Node& leaf = nodes[proxy];
+	leaf.index = index;
+	leaf.tight = toBox(bounds);
+
+	if (contains(leaf.fat, leaf.tight)) return false;
+
+	removeLeaf(proxy);
+
+	// stretch the new box in the direction of travel so it lasts a few more steps
+	Box fat = { leaf.tight.minX - margin, leaf.tight.minY - margin, leaf.tight.maxX + margin, leaf.tight.maxY + margin };
+	float dx = displacement.x * displacementMultiplier;
+	float dy = displacement.y * displacementMultiplier;
+	if (dx < 0) fat.minX += dx; else fat.maxX += dx;
+	if (dy < 0) fat.minY += dy; else fat.maxY += dy;
+	nodes[proxy].fat = fat;
+
+	insertLeaf(proxy);
+	return true;
+}
+
+void FizziksAABBTree::insertLeaf(int leaf) {
+	if (root < 0) {
+		root = leaf;
+		nodes[root].parent = -1;
+		return;
+	}
+
+	// walk down picking whichever side grows the total perimeter least
+	Box leafBox = nodes[leaf].fat;
+	int sibling = root;
+	while (!nodes[sibling].isLeaf()) {
+		int child1 = nodes[sibling].child1;
+		int child2 = nodes[sibling].child2;
+
+		float area = perimeter(nodes[sibling].fat);
+		float combinedArea = perimeter(combine(nodes[sibling].fat, leafBox));
+
+		// cost of making a new parent for this node and the leaf
+		float cost = 2.0f * combinedArea;
+
+		// minimum cost of pushing the leaf further down
+		float inheritanceCost = 2.0f * (combinedArea - area);
+
+		float cost1 = perimeter(combine(leafBox, nodes[child1].fat)) + inheritanceCost;
+		if (!nodes[child1].isLeaf()) cost1 -= perimeter(nodes[child1].fat);
+
+		float cost2 = perimeter(combine(leafBox, nodes[child2].fat)) + inheritanceCost;
+		if (!nodes[child2].isLeaf()) cost2 -= perimeter(nodes[child2].fat);
+
+		if (cost < cost1 && cost < cost2) break;
+
+		sibling = cost1 < cost2 ? child1 : child2;
+	}
+
+	int oldParent = nodes[sibling].parent;
+	int newParent = allocateNode();
+	nodes[newParent].parent = oldParent;
+	nodes[newParent].fat = combine(leafBox, nodes[sibling].fat);
+	nodes[newParent].height = nodes[sibling].height + 1;
+	nodes[newParent].child1 = sibling;
+	nodes[newParent].child2 = leaf;
+	nodes[sibling].parent = newParent;
+	nodes[leaf].parent = newParent;
+
+	if (oldParent >= 0) {
+		if (nodes[oldParent].child1 == sibling) nodes[oldParent].child1 = newParent;
+		else nodes[oldParent].child2 = newParent;
+	}
+	else {
+		root = newParent;
+	}
+
+	// refit and rebalance on the way back up
+	int node = nodes[leaf].parent;
+	while (node >= 0) {
+		node = balance(node);
+
+		int child1 = nodes[node].child1;
+		int child2 = nodes[node].child2;
+		nodes[node].height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+		nodes[node].fat = combine(nodes[child1].fat, nodes[child2].fat);
+
+		node = nodes[node].parent;
+	}
+}
+
+void FizziksAABBTree::removeLeaf(int leaf) {
+	if (leaf == root) {
+		root = -1;
+		return;
+	}
+
+	int parent = nodes[leaf].parent;
+	int grandParent = nodes[parent].parent;
+	int sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+	if (grandParent >= 0) {
+		// the sibling takes the parent's place
+		if (nodes[grandParent].child1 == parent) nodes[grandParent].child1 = sibling;
+		else nodes[grandParent].child2 = sibling;
+		nodes[sibling].parent = grandParent;
+		freeNode(parent);
+
+		int node = grandParent;
+		while (node >= 0) {
+			node = balance(node);
+
+			int child1 = nodes[node].child1;
+			int child2 = nodes[node].child2;
+			nodes[node].fat = combine(nodes[child1].fat, nodes[child2].fat);
+			nodes[node].height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+
+			node = nodes[node].parent;
+		}
+	}
+	else {
+		root = sibling;
+		nodes[sibling].parent = -1;
+		freeNode(parent);
+	}
+}
+
+// if one side of node a is more than one level taller than the other, rotate the
+// taller child up into a's place. returns the root of the rotated subtree.
+int FizziksAABBTree::balance(int a) {
+	Node& A = nodes[a];
+	if (A.isLeaf() || A.height < 2) return a;
+
+	int b = A.child1;
+	int c = A.child2;
+	int heightDifference = nodes[c].height - nodes[b].height;
+
+	if (heightDifference > 1) {
+		// rotate c up
+		int f = nodes[c].child1;
+		int g = nodes[c].child2;
+
+		nodes[c].child1 = a;
+		nodes[c].parent = A.parent;
+		A.parent = c;
+
+		if (nodes[c].parent >= 0) {
+			if (nodes[nodes[c].parent].child1 == a) nodes[nodes[c].parent].child1 = c;
+			else nodes[nodes[c].parent].child2 = c;
+		}
+		else {
+			root = c;
+		}
+
+		// the taller of c's children stays with c
+		if (nodes[f].height > nodes[g].height) {
+			nodes[c].child2 = f;
+			A.child2 = g;
+			nodes[g].parent = a;
+		}
+		else {
+			nodes[c].child2 = g;
+			A.child2 = f;
+			nodes[f].parent = a;
+		}
+
+		A.fat = combine(nodes[b].fat, nodes[A.child2].fat);
+		A.height = 1 + std::max(nodes[b].height, nodes[A.child2].height);
+		nodes[c].fat = combine(A.fat, nodes[nodes[c].child2].fat);
+		nodes[c].height = 1 + std::max(A.height, nodes[nodes[c].child2].height);
+		return c;
+	}
+
+	if (heightDifference < -1) {
+		// rotate b up
+		int d = nodes[b].child1;
+		int e = nodes[b].child2;
+
+		nodes[b].child1 = a;
+		nodes[b].parent = A.parent;
+		A.parent = b;
+
+		if (nodes[b].parent >= 0) {
+			if (nodes[nodes[b].parent].child1 == a) nodes[nodes[b].parent].child1 = b;
+			else nodes[nodes[b].parent].child2 = b;
+		}
+		else {
+			root = b;
+		}
+
+		if (nodes[d].height > nodes[e].height) {
+			nodes[b].child2 = d;
+			A.child1 = e;
+			nodes[e].parent = a;
+		}
+		else {
+			nodes[b].child2 = e;
+			A.child1 = d;
+			nodes[d].parent = a;
+		}
+
+		A.fat = combine(nodes[A.child1].fat, nodes[c].fat);
+		A.height = 1 + std::max(nodes[A.child1].height, nodes[c].height);
+		nodes[b].fat = combine(A.fat, nodes[nodes[b].child2].fat);
+		nodes[b].height = 1 + std::max(A.height, nodes[nodes[b].child2].height);
+		return b;
+	}
+
+	return a;
+}
+
+void FizziksAABBTree::findPairs(std::vector<FizziksPair>& pairs) {
+	if (root < 0) return;
+	size_t firstNewPair = pairs.size();
+
+	for (int leaf = 0; leaf < nodes.size(); leaf++) {
+		if (nodes[leaf].height != 0) continue;
+
+		const Box& query = nodes[leaf].tight;
+		int leafIndex = nodes[leaf].index;
+
+		stack.clear();
+		stack.push_back(root);
+		while (!stack.empty()) {
+			int id = stack.back();
+			stack.pop_back();
+			const Node& node = nodes[id];
+
+			if (!overlaps(node.fat, query)) continue;
+
+			if (node.isLeaf()) {
+				// each pair is found from both ends, keep the one from the lower index
+				if (node.index > leafIndex && overlaps(node.tight, query)) {
+					pairs.push_back({ leafIndex, node.index });
+				}
+			}
+			else {
+				stack.push_back(node.child1);
+				stack.push_back(node.child2);
+			}
+		}
+	}
+
+	std::sort(pairs.begin() + firstNewPair, pairs.end(), [](const FizziksPair& l, const FizziksPair& r) {
+		if (l.a != r.a) return l.a < r.a;
+		return l.b < r.b;
+	});
+}
+
+void FizziksAABBTree::queryPoint(Vector2 point, std::vector<int>& indices) {
+	queryRect({ point.x, point.y, 0, 0 }, indices);
+}
+
+void FizziksAABBTree::queryRect(Rectangle rect, std::vector<int>& indices) {
+	if (root < 0) return;
+	Box query = toBox(rect);
+
+	stack.clear();
+	stack.push_back(root);
+	while (!stack.empty()) {
+		int id = stack.back();
+		stack.pop_back();
+		const Node& node = nodes[id];
+
+		if (!overlaps(node.fat, query)) continue;
+
+		if (node.isLeaf()) {
+			indices.push_back(node.index);
+		}
+		else {
+			stack.push_back(node.child1);
+			stack.push_back(node.child2);
+		}
+	}
+}
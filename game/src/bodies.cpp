@@ -0,0 +1,235 @@
+#include "bodies.h"
+
+FizziksBodyHandle FizziksBodies::create(const FizziksBodyState& state) {
+	unsigned int slot;
+	if (freeSlot >= 0) {
+		slot = (unsigned int)freeSlot;
+		freeSlot = slots[slot].index;
+	}
+	else {
+		slot = (unsigned int)slots.size();
+		slots.push_back(Slot());
+	}
+
+	int index = size();
+	slots[slot].index = index;
+
+	positionX.push_back(0);
+	positionY.push_back(0);
+	velocityX.push_back(0);
+	velocityY.push_back(0);
+	forceX.push_back(0);
+	forceY.push_back(0);
+	mass.push_back(1);
+	inverseMass.push_back(1);
+	flags.push_back(0);
+	sleepTime.push_back(0);
+	previousX.push_back(0);
+	previousY.push_back(0);
+	slotOf.push_back(slot);
+
+	setState(index, state);
+
+	return { slot, slots[slot].generation };
+}
+
+void FizziksBodies::destroy(FizziksBodyHandle handle) {
+	int index = indexOf(handle);
+	if (index < 0) return;
+
+	positionX.erase(positionX.begin() + index);
+	positionY.erase(positionY.begin() + index);
+	velocityX.erase(velocityX.begin() + index);
+	velocityY.erase(velocityY.begin() + index);
+	forceX.erase(forceX.begin() + index);
+	forceY.erase(forceY.begin() + index);
+	mass.erase(mass.begin() + index);
+	inverseMass.erase(inverseMass.begin() + index);
+	flags.erase(flags.begin() + index);
+	sleepTime.erase(sleepTime.begin() + index);
+	previousX.erase(previousX.begin() + index);
+	previousY.erase(previousY.begin() + index);
+	slotOf.erase(slotOf.begin() + index);
+
+	// everything after the hole moved down one
+	for (int i = index; i < slotOf.size(); i++) {
+		slots[slotOf[i]].index = i;
+	}
+
+	slots[handle.slot].generation++;
+	slots[handle.slot].index = freeSlot;
+	freeSlot = (int)handle.slot;
+}
+
+void FizziksBodies::destroySwap(FizziksBodyHandle handle) {
+	int index = indexOf(handle);
+	if (index < 0) return;
+
+	int last = size() - 1;
+	positionX[index] = positionX[last];
+	positionY[index] = positionY[last];
+	velocityX[index] = velocityX[last];
+	velocityY[index] = velocityY[last];
+	forceX[index] = forceX[last];
+	forceY[index] = forceY[last];
+	mass[index] = mass[last];
+	inverseMass[index] = inverseMass[last];
+	flags[index] = flags[last];
+	sleepTime[index] = sleepTime[last];
+	previousX[index] = previousX[last];
+	previousY[index] = previousY[last];
+	slotOf[index] = slotOf[last];
+	slots[slotOf[index]].index = index;
+
+	positionX.pop_back();
+	positionY.pop_back();
+	velocityX.pop_back();
+	velocityY.pop_back();
+	forceX.pop_back();
+	forceY.pop_back();
+	mass.pop_back();
+	inverseMass.pop_back();
+	flags.pop_back();
+	sleepTime.pop_back();
+	previousX.pop_back();
+	previousY.pop_back();
+	slotOf.pop_back();
+
+	slots[handle.slot].generation++;
+	slots[handle.slot].index = freeSlot;
+	freeSlot = (int)handle.slot;
+}
+
+void FizziksBodies::removeDead() {
+	int kept = 0;
+	for (int i = 0; i < size(); i++) {
+		unsigned int slot = slotOf[i];
+		if (flags[i] & BODY_DEAD) {
+			slots[slot].generation++;
+			slots[slot].index = freeSlot;
+			freeSlot = (int)slot;
+			continue;
+		}
+
+		if (kept != i) {
+			positionX[kept] = positionX[i];
+			positionY[kept] = positionY[i];
+			velocityX[kept] = velocityX[i];
+			velocityY[kept] = velocityY[i];
+			forceX[kept] = forceX[i];
+			forceY[kept] = forceY[i];
+			mass[kept] = mass[i];
+			inverseMass[kept] = inverseMass[i];
+			flags[kept] = flags[i];
+			sleepTime[kept] = sleepTime[i];
+			previousX[kept] = previousX[i];
+			previousY[kept] = previousY[i];
+			slotOf[kept] = slot;
+			slots[slot].index = kept;
+		}
+		kept++;
+	}
+
+	positionX.resize(kept);
+	positionY.resize(kept);
+	velocityX.resize(kept);
+	velocityY.resize(kept);
+	forceX.resize(kept);
+	forceY.resize(kept);
+	mass.resize(kept);
+	inverseMass.resize(kept);
+	flags.resize(kept);
+	sleepTime.resize(kept);
+	previousX.resize(kept);
+	previousY.resize(kept);
+	slotOf.resize(kept);
+}
+
+int FizziksBodies::indexOf(FizziksBodyHandle handle) const {
+	if (handle.slot >= slots.size()) return -1;
+	const Slot& slot = slots[handle.slot];
+	if (slot.generation != handle.generation) return -1;
+	if (slot.index < 0 || slot.index >= size() || slotOf[slot.index] != handle.slot) return -1;
+	return slot.index;
+}
+
+FizziksBodyHandle FizziksBodies::handleAt(int index) const {
+	unsigned int slot = slotOf[index];
+	return { slot, slots[slot].generation };
+}
+
+FizziksBodyState FizziksBodies::getState(int index) const {
+	FizziksBodyState state;
+	state.position = { positionX[index], positionY[index] };
+	state.velocity = { velocityX[index], velocityY[index] };
+	state.netForce = { forceX[index], forceY[index] };
+	state.mass = mass[index];
+	state.isStatic = (flags[index] & BODY_STATIC) != 0;
+	state.isBullet = (flags[index] & BODY_BULLET) != 0;
+	return state;
+}
+
+void FizziksBodies::setState(int index, const FizziksBodyState& state) {
+	positionX[index] = state.position.x;
+	positionY[index] = state.position.y;
+	previousX[index] = state.position.x;
+	previousY[index] = state.position.y;
+	velocityX[index] = state.velocity.x;
+	velocityY[index] = state.velocity.y;
+	forceX[index] = state.netForce.x;
+	forceY[index] = state.netForce.y;
+	mass[index] = state.mass;
+	setStatic(index, state.isStatic);
+	setBullet(index, state.isBullet);
+}
+
+void FizziksBodies::setMass(int index, float newMass) {
+	mass[index] = newMass;
+	bool isStatic = (flags[index] & BODY_STATIC) != 0;
+	inverseMass[index] = (isStatic || newMass <= 0) ? 0 : 1.0f / newMass;
+}
+
+void FizziksBodies::setStatic(int index, bool isStatic) {
+	if (isStatic) flags[index] |= BODY_STATIC;
+	else flags[index] &= ~BODY_STATIC;
+	setMass(index, mass[index]);
+}
+
+void FizziksBodies::setBullet(int index, bool isBullet) {
+	if (isBullet) flags[index] |= BODY_BULLET;
+	else flags[index] &= ~BODY_BULLET;
+}
+
+void FizziksBodies::reserve(int count) {
+	positionX.reserve(count);
+	positionY.reserve(count);
+	velocityX.reserve(count);
+	velocityY.reserve(count);
+	forceX.reserve(count);
+	forceY.reserve(count);
+	mass.reserve(count);
+	inverseMass.reserve(count);
+	flags.reserve(count);
+	sleepTime.reserve(count);
+	previousX.reserve(count);
+	previousY.reserve(count);
+	slotOf.reserve(count);
+}
+
+void FizziksBodies::clear() {
+	positionX.clear();
+	positionY.clear();
+	velocityX.clear();
+	velocityY.clear();
+	forceX.clear();
+	forceY.clear();
+	mass.clear();
+	inverseMass.clear();
+	flags.clear();
+	sleepTime.clear();
+	previousX.clear();
+	previousY.clear();
+	slotOf.clear();
+	slots.clear();
+	freeSlot = -1;
+}
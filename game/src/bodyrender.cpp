@@ -0,0 +1,119 @@
+#include "bodyrender.h"
+#include "rlgl.h"
+#include <cstddef>
+
+// corner runs -1 to 1 both ways, the quad is the circle's square plus a pixel for the soft edge
+static const char* circleVertexShader = R"(#version 330
+layout(location = 0) in vec2 corner;
+layout(location = 1) in vec3 circle;
+layout(location = 2) in vec4 color;
+uniform mat4 mvp;
+out vec2 local;
+out float radius;
+out vec4 fragColor;
+void main() {
+	local = corner * (circle.z + 1.0);
+	radius = circle.z;
+	fragColor = color;
+	gl_Position = mvp * vec4(circle.xy + local, 0.0, 1.0);
+}
+)";
+
+// signed distance to the edge, faded out over a pixel
+static const char* circleFragmentShader = R"(#version 330
+in vec2 local;
+in float radius;
+in vec4 fragColor;
+out vec4 finalColor;
+void main() {
+	float edge = length(local) - radius;
+	float coverage = clamp(0.5 - edge / max(fwidth(edge), 0.0001), 0.0, 1.0);
+	if (coverage <= 0.0) discard;
+	finalColor = vec4(fragColor.rgb, fragColor.a * coverage);
+}
+)";
+
+// corner runs 0 to 1 both ways, from the box's top left
+static const char* rectVertexShader = R"(#version 330
+layout(location = 0) in vec2 corner;
+layout(location = 1) in vec4 rect;
+layout(location = 2) in vec4 color;
+uniform mat4 mvp;
+out vec4 fragColor;
+void main() {
+	fragColor = color;
+	gl_Position = mvp * vec4(rect.xy + corner * rect.zw, 0.0, 1.0);
+}
+)";
+
+static const char* rectFragmentShader = R"(#version 330
+in vec4 fragColor;
+out vec4 finalColor;
+void main() {
+	finalColor = fragColor;
+}
+)";
+
+static const float centredCorners[] = { -1, -1, 1, -1, 1, 1, -1, -1, 1, 1, -1, 1 };
+static const float unitCorners[] = { 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1 };
+
+static const FizziksInstanceAttribute circleAttributes[] = {
+	{ 3, RL_FLOAT, false, offsetof(FizziksCircleInstance, center) }, // centre and radius together
+	{ 4, RL_UNSIGNED_BYTE, true, offsetof(FizziksCircleInstance, color) }
+};
+
+static const FizziksInstanceAttribute rectAttributes[] = {
+	{ 4, RL_FLOAT, false, offsetof(FizziksRectInstance, rect) },
+	{ 4, RL_UNSIGNED_BYTE, true, offsetof(FizziksRectInstance, color) }
+};
+
+void FizziksBodyRenderer::load() {
+	circleQuads.load(circleVertexShader, circleFragmentShader, centredCorners, sizeof(FizziksCircleInstance), circleAttributes, 2);
+	rectQuads.load(rectVertexShader, rectFragmentShader, unitCorners, sizeof(FizziksRectInstance), rectAttributes, 2);
+	velocityRenderer.load();
+}
+
+void FizziksBodyRenderer::unload() {
+	circleQuads.unload();
+	rectQuads.unload();
+	velocityRenderer.unload();
+}
+
+void FizziksBodyRenderer::draw(const FizziksWorld& world, float interpolation, Rectangle view) {
+	const FizziksBodies& bodies = world.bodies;
+	circles.clear();
+	rects.clear();
+	velocities.clear();
+
+	// straight off the body arrays, the objekts are only asked their shape and looks
+	for (int i = 0; i < world.objekts.size(); i++) {
+		const FizziksObjekt* objekt = world.objekts[i];
+		FizziksShape shape = objekt->Shape();
+		if (shape == HALF_SPACE) continue;
+
+		Vector2 position = { Lerp(bodies.previousX[i], bodies.positionX[i], interpolation), Lerp(bodies.previousY[i], bodies.positionY[i], interpolation) };
+		Color color = (bodies.flags[i] & BODY_SLEEPING) ? ColorBrightness(objekt->color, -0.5f) : objekt->color;
+
+		if (shape == CIRCLE) {
+			float radius = ((const FizziksCircle*)objekt)->radius;
+			if (position.x + radius < view.x || position.x - radius > view.x + view.width
+				|| position.y + radius < view.y || position.y - radius > view.y + view.height) continue;
+			circles.push_back({ position, radius, color });
+			if (drawVelocities) velocities.push_back({ position, { position.x + bodies.velocityX[i], position.y + bodies.velocityY[i] }, 1, color });
+		}
+		else if (shape == AABB) {
+			Vector2 size = ((const FizziksAABB*)objekt)->sizeXY;
+			if (position.x + size.x < view.x || position.x > view.x + view.width
+				|| position.y + size.y < view.y || position.y > view.y + view.height) continue;
+			rects.push_back({ { position.x, position.y, size.x, size.y }, color });
+		}
+	}
+
+	if (rectQuads.isLoaded()) rectQuads.draw(rects.data(), (int)rects.size());
+	else for (const FizziksRectInstance& rect : rects) DrawRectangleRec(rect.rect, rect.color);
+
+	if (circleQuads.isLoaded()) circleQuads.draw(circles.data(), (int)circles.size());
+	else for (const FizziksCircleInstance& circle : circles) DrawCircleV(circle.center, circle.radius, circle.color);
+
+	velocityRenderer.drawLines(velocities);
+}
@@ -0,0 +1,260 @@
+#include "broadphase.h"
+#include <algorithm>
+#include <cmath>
+
+// touching counts as overlapping so the broad phase never drops a pair the narrow phase would keep
+bool BoundsOverlap(Rectangle a, Rectangle b) {
+	return a.x <= b.x + b.width && b.x <= a.x + a.width
+		&& a.y <= b.y + b.height && b.y <= a.y + a.height;
+}
+
+int FizziksSpatialHash::cellCoord(float v) const {
+	return (int)floorf(v / cellSize);
+}
+
+void FizziksSpatialHash::clear() {
+	proxies.clear();
+	entries.clear();
+	occupiedCells = 0;
+}
+
+void FizziksSpatialHash::insert(int index, Rectangle bounds) {
+	int proxy = (int)proxies.size();
+	proxies.push_back({ index, bounds });
+
+	int minX = cellCoord(bounds.x);
+	int minY = cellCoord(bounds.y);
+	int maxX = cellCoord(bounds.x + bounds.width);
+	int maxY = cellCoord(bounds.y + bounds.height);
+
+	for (int y = minY; y <= maxY; y++) {
+		for (int x = minX; x <= maxX; x++) {
+			entries.push_back({ x, y, proxy });
+		}
+	}
+}
+
+void FizziksSpatialHash::sortIntoCells() {
+	// sorting by cell puts everything sharing a cell next to each other
+	std::sort(entries.begin(), entries.end(), [](const Entry& l, const Entry& r) {
+		if (l.cellX != r.cellX) return l.cellX < r.cellX;
+		if (l.cellY != r.cellY) return l.cellY < r.cellY;
+		return l.proxy < r.proxy;
+	});
+
+	cellStarts.clear();
+	for (int i = 0; i < entries.size(); i++) {
+		if (i == 0 || entries[i].cellX != entries[i - 1].cellX || entries[i].cellY != entries[i - 1].cellY) cellStarts.push_back(i);
+	}
+	occupiedCells = (int)cellStarts.size();
+	cellStarts.push_back((int)entries.size());
+}
+
+Rectangle FizziksSpatialHash::cellBounds(int cell) const {
+	const Entry& entry = entries[cellStarts[cell]];
+	return { entry.cellX * cellSize, entry.cellY * cellSize, cellSize, cellSize };
+}
+
+void FizziksSpatialHash::cellPairs(int cell, std::vector<FizziksPair>& pairs) const {
+	int start = cellStarts[cell];
+	int end = cellStarts[cell + 1];
+	int cellX = entries[start].cellX;
+	int cellY = entries[start].cellY;
+
+	for (int i = start; i < end; i++) {
+		const Proxy& proxyA = proxies[entries[i].proxy];
+
+		for (int j = i + 1; j < end; j++) {
+			const Proxy& proxyB = proxies[entries[j].proxy];
+
+			if (!BoundsOverlap(proxyA.bounds, proxyB.bounds)) continue;
+
+			// only the cell owning the overlap's top-left corner reports the pair
+			float overlapX = fmaxf(proxyA.bounds.x, proxyB.bounds.x);
+			float overlapY = fmaxf(proxyA.bounds.y, proxyB.bounds.y);
+			if (cellCoord(overlapX) != cellX || cellCoord(overlapY) != cellY) continue;
+
+			int a = proxyA.index;
+			int b = proxyB.index;
+			if (a > b) std::swap(a, b);
+			pairs.push_back({ a, b });
+		}
+	}
+}
+
+static void SortPairs(std::vector<FizziksPair>::iterator begin, std::vector<FizziksPair>::iterator end) {
+	std::sort(begin, end, [](const FizziksPair& l, const FizziksPair& r) {
+		if (l.a != r.a) return l.a < r.a;
+		return l.b < r.b;
+	});
+}
+
+void FizziksSpatialHash::findPairs(std::vector<FizziksPair>& pairs) {
+	size_t firstNewPair = pairs.size();
+
+	sortIntoCells();
+	for (int cell = 0; cell < occupiedCells; cell++) cellPairs(cell, pairs);
+
+	SortPairs(pairs.begin() + firstNewPair, pairs.end());
+}
+
+void FizziksSpatialHash::findPairs(std::vector<FizziksPair>& pairs, FizziksThreadPool& threads) {
+	size_t firstNewPair = pairs.size();
+
+	sortIntoCells();
+	if (workerPairs.size() < threads.threadCount()) workerPairs.resize(threads.threadCount());
+	for (std::vector<FizziksPair>& found : workerPairs) found.clear();
+
+	threads.parallelFor(occupiedCells, 64, [&](int begin, int end, int worker) {
+		for (int cell = begin; cell < end; cell++) cellPairs(cell, workerPairs[worker]);
+	});
+
+	// which thread found what changes from run to run, the sort puts it back the same every time
+	for (const std::vector<FizziksPair>& found : workerPairs) pairs.insert(pairs.end(), found.begin(), found.end());
+	SortPairs(pairs.begin() + firstNewPair, pairs.end());
+}
+
+int FizziksSweepAndPrune::update(int proxy, int index, Rectangle bounds) {
+	if (proxy < 0 || proxy >= proxies.size() || proxies[proxy].index < 0) {
+		if (!freeProxies.empty()) {
+			proxy = freeProxies.back();
+			freeProxies.pop_back();
+		}
+		else {
+			proxy = (int)proxies.size();
+			proxies.push_back(Proxy());
+			activeSlot.push_back(-1);
+		}
+
+		// new endpoints go on the end and the next sort moves them into place
+		for (int axis = 0; axis < 2; axis++) {
+			endpoints[axis].push_back({ 0, proxy, false });
+			endpoints[axis].push_back({ 0, proxy, true });
+		}
+		addedEndpoints += 2;
+	}
+
+	proxies[proxy].index = index;
+	proxies[proxy].bounds = bounds;
+	proxies[proxy].stamp = stamp;
+	return proxy;
+}
+
+void FizziksSweepAndPrune::removeStaleProxies() {
+	bool anyStale = false;
+	for (int i = 0; i < proxies.size(); i++) {
+		if (proxies[i].index >= 0 && proxies[i].stamp != stamp) {
+			proxies[i].index = -1;
+			freeProxies.push_back(i);
+			anyStale = true;
+		}
+	}
+	if (!anyStale) return;
+
+	for (int axis = 0; axis < 2; axis++) {
+		std::vector<Endpoint>& list = endpoints[axis];
+		list.erase(std::remove_if(list.begin(), list.end(), [this](const Endpoint& e) {
+			return proxies[e.proxy].index < 0;
+		}), list.end());
+	}
+}
+
+void FizziksSweepAndPrune::refreshEndpoints(int axis) {
+	std::vector<Endpoint>& list = endpoints[axis];
+
+	for (int i = 0; i < list.size(); i++) {
+		const Rectangle& b = proxies[list[i].proxy].bounds;
+		float min = axis == 0 ? b.x : b.y;
+		float extent = axis == 0 ? b.width : b.height;
+		list[i].value = list[i].isMax ? min + extent : min;
+	}
+
+	// mins before maxes on ties so touching bounds still overlap
+	auto before = [](const Endpoint& a, const Endpoint& b) {
+		return a.value < b.value || (a.value == b.value && !a.isMax && b.isMax);
+	};
+
+	// a big batch of new proxies sits unsorted on the end, a full sort beats inserting each one
+	if (addedEndpoints * 4 > (int)list.size()) {
+		std::stable_sort(list.begin(), list.end(), before);
+		return;
+	}
+
+	// otherwise it's nearly sorted from last step and an insertion sort is close to linear
+	for (int i = 1; i < list.size(); i++) {
+		Endpoint key = list[i];
+		int j = i - 1;
+		while (j >= 0 && before(key, list[j])) {
+			list[j + 1] = list[j];
+			j--;
+		}
+		list[j + 1] = key;
+	}
+}
+
+void FizziksSweepAndPrune::findPairs(std::vector<FizziksPair>& pairs) {
+	removeStaleProxies();
+	size_t firstNewPair = pairs.size();
+
+	// sweep along whichever axis the objekts are most spread out on
+	float sum[2] = { 0, 0 };
+	float sumSquares[2] = { 0, 0 };
+	int count = 0;
+	for (int i = 0; i < proxies.size(); i++) {
+		if (proxies[i].index < 0) continue;
+		const Rectangle& b = proxies[i].bounds;
+		float centerX = b.x + b.width * 0.5f;
+		float centerY = b.y + b.height * 0.5f;
+		sum[0] += centerX;
+		sum[1] += centerY;
+		sumSquares[0] += centerX * centerX;
+		sumSquares[1] += centerY * centerY;
+		count++;
+	}
+	if (count > 0) {
+		float varianceX = sumSquares[0] / count - (sum[0] / count) * (sum[0] / count);
+		float varianceY = sumSquares[1] / count - (sum[1] / count) * (sum[1] / count);
+		sweepAxis = varianceY > varianceX ? 1 : 0;
+	}
+
+	// both lists every step, not just the one swept. each only moves a little and stays nearly sorted,
+	// where one left alone would pay for every inversion since it was last used when the axis flips
+	refreshEndpoints(0);
+	refreshEndpoints(1);
+	addedEndpoints = 0;
+
+	active.clear();
+	const std::vector<Endpoint>& list = endpoints[sweepAxis];
+	for (int i = 0; i < list.size(); i++) {
+		const Endpoint& e = list[i];
+
+		if (e.isMax) {
+			// swap-and-pop out of the active list
+			int slot = activeSlot[e.proxy];
+			int last = active.back();
+			active[slot] = last;
+			activeSlot[last] = slot;
+			active.pop_back();
+			activeSlot[e.proxy] = -1;
+			continue;
+		}
+
+		const Proxy& proxyA = proxies[e.proxy];
+		for (int k = 0; k < active.size(); k++) {
+			const Proxy& proxyB = proxies[active[k]];
+			if (!BoundsOverlap(proxyA.bounds, proxyB.bounds)) continue;
+
+			int a = proxyA.index;
+			int b = proxyB.index;
+			if (a > b) std::swap(a, b);
+			pairs.push_back({ a, b });
+		}
+
+		activeSlot[e.proxy] = (int)active.size();
+		active.push_back(e.proxy);
+	}
+
+	SortPairs(pairs.begin() + firstNewPair, pairs.end());
+
+	stamp++;
+}
@@ -0,0 +1,35 @@
+#include "debugdraw.h"
+#include <algorithm>
+
+void FizziksDebugDraw::rect(FizziksDebugCategory category, Rectangle rect, float thickness, Color color) {
+	if (!wants(category)) return;
+	Vector2 topLeft = { rect.x, rect.y };
+	Vector2 topRight = { rect.x + rect.width, rect.y };
+	Vector2 bottomRight = { rect.x + rect.width, rect.y + rect.height };
+	Vector2 bottomLeft = { rect.x, rect.y + rect.height };
+	lines.push_back({ topLeft, topRight, thickness, color });
+	lines.push_back({ topRight, bottomRight, thickness, color });
+	lines.push_back({ bottomRight, bottomLeft, thickness, color });
+	lines.push_back({ bottomLeft, topLeft, thickness, color });
+}
+
+void FizziksDebugDraw::cull(Rectangle view, std::vector<FizziksDebugLine>& visible) const {
+	visible.clear();
+	for (const FizziksDebugLine& line : lines) {
+		// the line's bounds, grown by its thickness, against the view
+		float pad = line.thickness;
+		if (std::max(line.start.x, line.end.x) + pad < view.x || std::min(line.start.x, line.end.x) - pad > view.x + view.width) continue;
+		if (std::max(line.start.y, line.end.y) + pad < view.y || std::min(line.start.y, line.end.y) - pad > view.y + view.height) continue;
+		visible.push_back(line);
+	}
+}
+
+const char* FizziksDebugCategoryName(FizziksDebugCategory category) {
+	switch (category) {
+	case DEBUG_FORCES: return "forces";
+	case DEBUG_CONTACTS: return "contacts";
+	case DEBUG_AABBS: return "bounds";
+	case DEBUG_BROADPHASE: return "broad phase";
+	default: return "?";
+	}
+}
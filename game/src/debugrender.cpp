@@ -0,0 +1,57 @@
+#include "debugrender.h"
+#include "rlgl.h"
+#include <cstddef>
+
+// corner.x runs 0 to 1 along the line, corner.y -0.5 to 0.5 across it
+static const char* lineVertexShader = R"(#version 330
+layout(location = 0) in vec2 corner;
+layout(location = 1) in vec4 ends;
+layout(location = 2) in float thickness;
+layout(location = 3) in vec4 color;
+uniform mat4 mvp;
+out vec4 fragColor;
+void main() {
+	vec2 along = ends.zw - ends.xy;
+	float span = length(along);
+	vec2 direction = span > 0.0 ? along / span : vec2(1.0, 0.0);
+	vec2 across = vec2(-direction.y, direction.x) * thickness;
+	fragColor = color;
+	gl_Position = mvp * vec4(ends.xy + along * corner.x + across * corner.y, 0.0, 1.0);
+}
+)";
+
+static const char* lineFragmentShader = R"(#version 330
+in vec4 fragColor;
+out vec4 finalColor;
+void main() {
+	finalColor = fragColor;
+}
+)";
+
+static const float quadCorners[] = { 0, -0.5f, 1, -0.5f, 1, 0.5f, 0, -0.5f, 1, 0.5f, 0, 0.5f };
+
+static const FizziksInstanceAttribute lineAttributes[] = {
+	{ 4, RL_FLOAT, false, offsetof(FizziksDebugLine, start) }, // start and end together
+	{ 1, RL_FLOAT, false, offsetof(FizziksDebugLine, thickness) },
+	{ 4, RL_UNSIGNED_BYTE, true, offsetof(FizziksDebugLine, color) }
+};
+
+void FizziksDebugRenderer::load() {
+	quads.load(lineVertexShader, lineFragmentShader, quadCorners, sizeof(FizziksDebugLine), lineAttributes, 3);
+}
+
+void FizziksDebugRenderer::draw(const FizziksDebugDraw& debugDraw, Rectangle view) {
+	debugDraw.cull(view, visible);
+	drawLines(visible);
+}
+
+void FizziksDebugRenderer::drawLines(const std::vector<FizziksDebugLine>& lines) {
+	drawn = (int)lines.size();
+	if (drawn == 0) return;
+
+	if (!quads.isLoaded()) {
+		for (const FizziksDebugLine& line : lines) DrawLineEx(line.start, line.end, line.thickness, line.color);
+		return;
+	}
+	quads.draw(lines.data(), drawn);
+}
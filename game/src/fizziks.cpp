@@ -0,0 +1,1238 @@
+#include "fizziks.h"
+#include <cfloat>
+
+typedef bool (*CollideFn)(FizziksObjekt* a, FizziksObjekt* b, FizziksWorld& world);
+typedef void (*DetectBatchFn)(const FizziksPair* pairs, int begin, int end, FizziksObjekt* const* objekts, std::vector<FizziksContact>& contacts);
+typedef void (*ResolveBatchFn)(const FizziksContact* contacts, int count, FizziksWorld& world);
+
+template <typename A, typename B, bool (*Overlap)(A*, B*, FizziksWorld&)>
+static bool Collide(FizziksObjekt* a, FizziksObjekt* b, FizziksWorld& world) {
+	return Overlap(static_cast<A*>(a), static_cast<B*>(b), world);
+}
+
+// the batch versions run one kernel over a bucket that's all the same shape pair, so the call inlines
+template <typename A, typename B, bool (*Detect)(const A*, const B*, FizziksContact*)>
+static void DetectBatch(const FizziksPair* pairs, int begin, int end, FizziksObjekt* const* objekts, std::vector<FizziksContact>& contacts) {
+	FizziksContact contact;
+	for (int p = begin; p < end; p++) {
+		int a = pairs[p].a;
+		int b = pairs[p].b;
+		if (Detect(static_cast<const A*>(objekts[a]), static_cast<const B*>(objekts[b]), &contact)) {
+			contact.a = a;
+			contact.b = b;
+			contact.friction = objekts[a]->grippiness * objekts[b]->grippiness;
+			contact.restitution = objekts[a]->bounciness * objekts[b]->bounciness;
+			contacts.push_back(contact);
+		}
+	}
+}
+
+template <typename A, typename B, void (*Resolve)(A*, B*, const FizziksContact&, FizziksWorld&)>
+static void ResolveBatch(const FizziksContact* contacts, int count, FizziksWorld& world) {
+	FizziksObjekt** objekts = world.objekts.data();
+	unsigned char* colliding = world.colliding.data();
+	for (int c = 0; c < count; c++) {
+		const FizziksContact& contact = contacts[c];
+		Resolve(static_cast<A*>(objekts[contact.a]), static_cast<B*>(objekts[contact.b]), contact, world);
+		colliding[contact.a] = 1;
+		colliding[contact.b] = 1;
+	}
+}
+
+struct CollisionKernel {
+	FizziksShape first;
+	FizziksShape second;
+	CollideFn collide;
+	DetectBatchFn detectBatch;
+	ResolveBatchFn resolveBatch;
+};
+
+// one entry per pair of shapes that can collide, in the order the functions take them.
+// the mirrored order is filled in by CollisionTable
+static const CollisionKernel kernels[] = {
+	{ CIRCLE, CIRCLE, Collide<FizziksCircle, FizziksCircle, CircleCircleOverlap>,
+		DetectBatch<FizziksCircle, FizziksCircle, CircleCircleContact>, ResolveBatch<FizziksCircle, FizziksCircle, CircleCircleResolve> },
+	{ CIRCLE, HALF_SPACE, Collide<FizziksCircle, FizziksHalfspace, CircleHalfspaceOverlap>,
+		DetectBatch<FizziksCircle, FizziksHalfspace, CircleHalfspaceContact>, ResolveBatch<FizziksCircle, FizziksHalfspace, CircleHalfspaceResolve> },
+	{ AABB, AABB, Collide<FizziksAABB, FizziksAABB, AABBAABBOverlap>,
+		DetectBatch<FizziksAABB, FizziksAABB, AABBAABBContact>, ResolveBatch<FizziksAABB, FizziksAABB, AABBAABBResolve> },
+	{ AABB, CIRCLE, Collide<FizziksAABB, FizziksCircle, AABBCircleOverlap>,
+		DetectBatch<FizziksAABB, FizziksCircle, AABBCircleContact>, ResolveBatch<FizziksAABB, FizziksCircle, AABBCircleResolve> },
+	{ AABB, HALF_SPACE, Collide<FizziksAABB, FizziksHalfspace, AABBHalfspaceOverlap>,
+		DetectBatch<FizziksAABB, FizziksHalfspace, AABBHalfspaceContact>, ResolveBatch<FizziksAABB, FizziksHalfspace, AABBHalfspaceResolve> },
+};
+
+static const int kernelCount = sizeof(kernels) / sizeof(kernels[0]);
+
+struct CollisionEntry {
+	const CollisionKernel* kernel = nullptr; // nullptr when the shapes never collide
+	bool swapped = false; // hand the pair to the kernel the other way round
+};
+
+// dense [shape][shape] lookup built from kernels, one load per pair instead of an if chain
+struct CollisionTable {
+	CollisionEntry entries[SHAPE_COUNT][SHAPE_COUNT];
+
+	CollisionTable() {
+		for (const CollisionKernel& kernel : kernels) {
+			entries[kernel.first][kernel.second] = { &kernel, false };
+			if (kernel.first != kernel.second) entries[kernel.second][kernel.first] = { &kernel, true };
+		}
+	}
+};
+
+static const CollisionTable collisionTable;
+
+// runs kernel's detection over bucket on every thread and appends what it finds to
+// world.contacts in pair order, so the result never depends on the thread count
+static void DetectContacts(FizziksWorld& world, const CollisionKernel& kernel, const std::vector<FizziksPair>& bucket) {
+	int pairCount = (int)bucket.size();
+	if (pairCount == 0) return;
+
+	int grain = world.detectGrain > 0 ? world.detectGrain : 1;
+	world.workerContacts.resize(world.threads.threadCount());
+	for (std::vector<FizziksContact>& buffer : world.workerContacts) buffer.clear();
+	world.contactChunks.resize((pairCount + grain - 1) / grain);
+
+	world.threads.parallelFor(pairCount, grain, [&](int begin, int end, int worker) {
+		std::vector<FizziksContact>& buffer = world.workerContacts[worker];
+		int first = (int)buffer.size();
+		kernel.detectBatch(bucket.data(), begin, end, world.objekts.data(), buffer);
+		world.contactChunks[begin / grain] = { worker, first, (int)buffer.size() - first };
+	});
+
+	for (const FizziksWorld::ContactChunk& chunk : world.contactChunks) {
+		const FizziksContact* found = world.workerContacts[chunk.worker].data() + chunk.begin;
+		world.contacts.insert(world.contacts.end(), found, found + chunk.count);
+	}
+}
+
+FizziksCircle* FizziksWorld::createCircle() {
+	FizziksCircle* circle = circlePool.create();
+	circle->pooled = true;
+	add(circle);
+	return circle;
+}
+
+FizziksAABB* FizziksWorld::createAABB() {
+	FizziksAABB* aabb = aabbPool.create();
+	aabb->pooled = true;
+	add(aabb);
+	return aabb;
+}
+
+FizziksHalfspace* FizziksWorld::createHalfspace() {
+	FizziksHalfspace* halfspace = halfspacePool.create();
+	halfspace->pooled = true;
+	add(halfspace);
+	return halfspace;
+}
+
+void FizziksWorld::add(FizziksObjekt* newObject) {
+	objekts.push_back(newObject);
+	newObject->attach(&bodies);
+}
+
+void FizziksWorld::remove(int index) {
+	FizziksObjekt* objekt = objekts[index];
+	if (objekt->isDead()) killed--;
+	if (objekt->treeProxy >= 0) {
+		tree.remove(objekt->treeProxy);
+		objekt->treeProxy = -1;
+	}
+	// the sweep and prune proxy is freed when it isn't updated next step, this one mustn't hold on to it
+	// in case it's added back and ends up sharing it with whoever gets it next
+	objekt->broadphaseProxy = -1;
+	islands.wakeTouching(index, bodies);
+	objekt->detach();
+
+	// same swap the body arrays just did
+	int last = (int)objekts.size() - 1;
+	objekts[index] = objekts[last];
+	objekts.pop_back();
+	if (index < last && objekts[index]->treeProxy >= 0) tree.setLeafIndex(objekts[index]->treeProxy, index);
+}
+
+void FizziksWorld::destroy(int index) {
+	FizziksObjekt* objekt = objekts[index];
+	remove(index);
+	recycle(objekt);
+}
+
+void FizziksWorld::kill(int index) {
+	if (bodies.flags[index] & BODY_DEAD) return;
+	bodies.flags[index] |= BODY_DEAD;
+	killed++;
+}
+
+void FizziksWorld::flushDestroyed() {
+	if (killed == 0) return;
+
+	int kept = 0;
+	for (int i = 0; i < objekts.size(); i++) {
+		FizziksObjekt* objekt = objekts[i];
+
+		if (bodies.flags[i] & BODY_DEAD) {
+			if (objekt->treeProxy >= 0) {
+				tree.remove(objekt->treeProxy);
+				objekt->treeProxy = -1;
+			}
+			objekt->broadphaseProxy = -1;
+			objekt->release();
+			recycle(objekt);
+			continue;
+		}
+
+		if (kept != i) {
+			objekts[kept] = objekt;
+			if (objekt->treeProxy >= 0) tree.setLeafIndex(objekt->treeProxy, kept);
+		}
+		kept++;
+	}
+	objekts.resize(kept);
+
+	// same pass over the body arrays, they were flagged in the same places
+	islands.wakeTouchingDead(bodies);
+	bodies.removeDead();
+	killed = 0;
+}
+
+void FizziksWorld::recycle(FizziksObjekt* objekt) {
+	if (!objekt->pooled) return;
+
+	switch (objekt->Shape()) {
+	case CIRCLE: circlePool.destroy((FizziksCircle*)objekt); break;
+	case HALF_SPACE: halfspacePool.destroy((FizziksHalfspace*)objekt); break;
+	case AABB: aabbPool.destroy((FizziksAABB*)objekt); break;
+	default: break;
+	}
+}
+
+void FizziksWorld::syncTree() {
+	for (int i = 0; i < objekts.size(); i++) {
+		FizziksObjekt* objekt = objekts[i];
+		if (objekt->Shape() == HALF_SPACE) continue;
+
+		if (objekt->treeProxy < 0) objekt->treeProxy = tree.insert(i, objekt->getBounds());
+		else tree.move(objekt->treeProxy, i, objekt->getBounds(), objekt->getVelocity() * dt);
+	}
+}
+
+FizziksObjekt* FizziksWorld::queryPoint(Vector2 point) {
+	queryResults.clear();
+	tree.queryPoint(point, queryResults);
+
+	int best = -1;
+	for (int k = 0; k < queryResults.size(); k++) {
+		int i = queryResults[k];
+		if (i > best && objekts[i]->containsPoint(point)) best = i;
+	}
+	return best >= 0 ? objekts[best] : nullptr;
+}
+
+void FizziksWorld::queryRect(Rectangle rect, std::vector<FizziksObjekt*>& found) {
+	queryResults.clear();
+	tree.queryRect(rect, queryResults);
+	// the tree's boxes are fattened and stretched along the velocity, so check the real bounds
+	for (int k = 0; k < queryResults.size(); k++) {
+		FizziksObjekt* objekt = objekts[queryResults[k]];
+		if (BoundsOverlap(objekt->getBounds(), rect)) found.push_back(objekt);
+	}
+}
+
+FizziksObjekt* FizziksWorld::raycast(Vector2 from, Vector2 to, Vector2* hitPoint) {
+	int hitIndex = -1;
+	float hitFraction = 1.0f;
+
+	tree.raycast(from, to, [&](int index, float maxFraction) {
+		float fraction = objekts[index]->raycast(from, to);
+		if (fraction < 0.0f || fraction > maxFraction) return maxFraction;
+		hitIndex = index;
+		hitFraction = fraction;
+		return fraction;
+	});
+
+	if (hitIndex < 0) return nullptr;
+	if (hitPoint) *hitPoint = Vector2Lerp(from, to, hitFraction);
+	return objekts[hitIndex];
+}
+
+void FizziksWorld::resetNetForces() {
+	std::fill(bodies.forceX.begin(), bodies.forceX.end(), 0.0f);
+	std::fill(bodies.forceY.begin(), bodies.forceY.end(), 0.0f);
+}
+
+void FizziksWorld::addGravityForces() {
+	threads.parallelFor(bodies.size(), integrateGrain, [&](int begin, int end, int worker) {
+		FizziksAddGravity(bodies, accelerationGravity, simdLevel, begin, end);
+	});
+	if (!debugDraw.wants(DEBUG_FORCES)) return;
+
+	for (int i = 0; i < bodies.size(); i++) {
+
+		if (bodies.flags[i] & BODY_NOT_MOVING) continue;
+
+		Vector2 FGravity = accelerationGravity * bodies.mass[i];
+		Vector2 position = { bodies.positionX[i], bodies.positionY[i] };
+		debugDraw.line(DEBUG_FORCES, position, position + FGravity, 1, PURPLE);
+	}
+}
+
+void FizziksWorld::applyKinematics() {
+	threads.parallelFor(bodies.size(), integrateGrain, [&](int begin, int end, int worker) {
+		FizziksIntegrate(bodies, dt, simdLevel, begin, end);
+	});
+}
+
+void FizziksWorld::rememberBullets() {
+	bullets.clear();
+	bulletStarts.clear();
+	if (!continuousCollision) return;
+
+	for (int i = 0; i < bodies.size(); i++) {
+		if ((bodies.flags[i] & (BODY_BULLET | BODY_NOT_MOVING | BODY_DEAD)) != BODY_BULLET) continue;
+		bullets.push_back(i);
+		bulletStarts.push_back({ bodies.positionX[i], bodies.positionY[i] });
+	}
+}
+
+static bool TimeOfImpact(FizziksObjekt* bullet, Vector2 start, Vector2 motion, FizziksObjekt* other, float* fraction, Vector2* normal) {
+	if (bullet->Shape() == CIRCLE) {
+		const FizziksCircle* circle = (const FizziksCircle*)bullet;
+		switch (other->Shape()) {
+		case CIRCLE: return CircleCircleTimeOfImpact(circle, start, motion, (const FizziksCircle*)other, fraction, normal);
+		case AABB: return CircleAABBTimeOfImpact(circle, start, motion, (const FizziksAABB*)other, fraction, normal);
+		case HALF_SPACE: return CircleHalfspaceTimeOfImpact(circle, start, motion, (const FizziksHalfspace*)other, fraction, normal);
+		default: return false;
+		}
+	}
+	if (bullet->Shape() == AABB) {
+		const FizziksAABB* aabb = (const FizziksAABB*)bullet;
+		switch (other->Shape()) {
+		case CIRCLE: return AABBCircleTimeOfImpact(aabb, start, motion, (const FizziksCircle*)other, fraction, normal);
+		case AABB: return AABBAABBTimeOfImpact(aabb, start, motion, (const FizziksAABB*)other, fraction, normal);
+		case HALF_SPACE: return AABBHalfspaceTimeOfImpact(aabb, start, motion, (const FizziksHalfspace*)other, fraction, normal);
+		default: return false;
+		}
+	}
+	return false;
+}
+
+void FizziksWorld::sweepBullets() {
+	bulletHits = 0;
+	if (bullets.empty()) return;
+
+	// the leaves were last synced in checkCollisions, before anything moved. TimeOfImpact tests against
+	// where everyone is now, so the tree has to be too, or a body that moved into the path is never tried
+	syncTree();
+
+	for (int k = 0; k < bullets.size(); k++) {
+		int i = bullets[k];
+		FizziksObjekt* bullet = objekts[i];
+		Vector2 start = bulletStarts[k];
+		Vector2 end = bullet->getPosition();
+		Vector2 motion = end - start;
+		if (motion.x == 0 && motion.y == 0) continue;
+
+		// everything the bullet's bounds pass over on the way from start to end
+		Rectangle bounds = bullet->getBounds();
+		Rectangle swept = { fminf(start.x, end.x) + bounds.x - end.x, fminf(start.y, end.y) + bounds.y - end.y,
+			bounds.width + fabsf(motion.x), bounds.height + fabsf(motion.y) };
+		queryResults.clear();
+		tree.queryRect(swept, queryResults);
+		queryResults.insert(queryResults.end(), alwaysTest.begin(), alwaysTest.end());
+
+		// the earliest hit, the lower index on a tie so the tree's order doesn't matter
+		int hit = -1;
+		float hitFraction = 1;
+		Vector2 hitNormal = { 0, 0 };
+		for (int q = 0; q < queryResults.size(); q++) {
+			int j = queryResults[q];
+			if (j == i || (bodies.flags[j] & BODY_DEAD)) continue;
+
+			float fraction;
+			Vector2 normal;
+			if (!TimeOfImpact(bullet, start, motion, objekts[j], &fraction, &normal)) continue;
+			if (hit < 0 || fraction < hitFraction || (fraction == hitFraction && j < hit)) {
+				hit = j;
+				hitFraction = fraction;
+				hitNormal = normal;
+			}
+		}
+		if (hit < 0) continue;
+
+		// stop it where it touched, the rest of the step is lost. next step's narrow phase takes it from there
+		Vector2 at = start + motion * hitFraction;
+		bodies.positionX[i] = at.x;
+		bodies.positionY[i] = at.y;
+
+		float inverseMassA = bodies.inverseMass[i];
+		float inverseMassB = bodies.inverseMass[hit];
+		Vector2 relativeVelocity = { bodies.velocityX[hit] - bodies.velocityX[i], bodies.velocityY[hit] - bodies.velocityY[i] };
+		float closing = Vector2DotProduct(relativeVelocity, hitNormal);
+		if (closing < 0 && inverseMassA + inverseMassB > 0) {
+			float restitution = bullet->bounciness * objekts[hit]->bounciness;
+			Vector2 impulse = hitNormal * (-(1 + restitution) * closing / (inverseMassA + inverseMassB));
+			bodies.velocityX[i] -= impulse.x * inverseMassA;
+			bodies.velocityY[i] -= impulse.y * inverseMassA;
+			bodies.velocityX[hit] += impulse.x * inverseMassB;
+			bodies.velocityY[hit] += impulse.y * inverseMassB;
+		}
+		if (bodies.flags[hit] & BODY_SLEEPING) bodies.wake(hit);
+
+		debugDraw.line(DEBUG_CONTACTS, start, at, 1, SKYBLUE);
+		bulletHits++;
+	}
+}
+
+void FizziksWorld::applyBounds() {
+	if (boundsPolicy == BOUNDS_NONE) return;
+
+	float minX = bounds.x;
+	float minY = bounds.y;
+	float maxX = bounds.x + bounds.width;
+	float maxY = bounds.y + bounds.height;
+
+	for (int i = 0; i < bodies.size(); i++) {
+		if (bodies.flags[i] & BODY_STATIC) continue; // takes care of half-spaces too
+
+		float& x = bodies.positionX[i];
+		float& y = bodies.positionY[i];
+
+		if (boundsPolicy == BOUNDS_CLAMP) {
+			// the whole body is kept in, not just its position, which is a corner for an AABB.
+			// only the velocity heading further out gets stopped, and the min edge wins if it doesn't fit
+			Rectangle extent = objekts[i]->getBounds();
+			float outX = extent.x + extent.width - maxX;
+			float outY = extent.y + extent.height - maxY;
+			if (outX > 0) { x -= outX; extent.x -= outX; bodies.velocityX[i] = fminf(bodies.velocityX[i], 0); }
+			if (outY > 0) { y -= outY; extent.y -= outY; bodies.velocityY[i] = fminf(bodies.velocityY[i], 0); }
+			if (extent.x < minX) { x += minX - extent.x; bodies.velocityX[i] = fmaxf(bodies.velocityX[i], 0); }
+			if (extent.y < minY) { y += minY - extent.y; bodies.velocityY[i] = fmaxf(bodies.velocityY[i], 0); }
+			continue;
+		}
+
+		if (x >= minX && x <= maxX && y >= minY && y <= maxY) continue;
+
+		if (boundsPolicy == BOUNDS_KILL) {
+			kill(i);
+		}
+		else if (boundsPolicy == BOUNDS_WRAP) {
+			// previous goes round with it, or it'd be drawn streaking back across the screen
+			float shiftX = bounds.width > 0 ? floorf((x - minX) / bounds.width) * bounds.width : 0;
+			float shiftY = bounds.height > 0 ? floorf((y - minY) / bounds.height) * bounds.height : 0;
+			x -= shiftX;
+			y -= shiftY;
+			bodies.previousX[i] -= shiftX;
+			bodies.previousY[i] -= shiftY;
+		}
+	}
+}
+
+void FizziksWorld::update(float deltaTime) {
+	FIZZIKS_PROFILE_FRAME(profiler);
+	debugDraw.clear();
+
+	bodies.stepping = true;
+	int passes = substeps > 1 ? substeps : 1;
+	for (int pass = 0; pass < passes; pass++) substep(deltaTime / passes);
+	bodies.stepping = false;
+	recordDebugShapes();
+	FIZZIKS_PROFILE_COUNT(profiler, PROFILE_ACTIVE_BODIES, bodies.size() - islands.sleepingCount());
+
+	if (deterministic) {
+		FIZZIKS_PROFILE_SCOPE(profiler, PROFILE_HASH);
+		frameHash = stateHash();
+	}
+}
+
+void FizziksWorld::recordDebugShapes() {
+	if (debugDraw.wants(DEBUG_AABBS)) {
+		for (int i = 0; i < objekts.size(); i++) {
+			if (objekts[i]->Shape() == HALF_SPACE) continue;
+			debugDraw.rect(DEBUG_AABBS, objekts[i]->getBounds(), 1, objekts[i]->isSleeping() ? DARKGRAY : YELLOW);
+		}
+	}
+
+	if (debugDraw.wants(DEBUG_BROADPHASE)) {
+		debugBounds.clear();
+		if (broadphaseMode == BROADPHASE_SPATIAL_HASH) {
+			for (int cell = 0; cell < spatialHash.cellCount(); cell++) debugBounds.push_back(spatialHash.cellBounds(cell));
+		}
+		else if (broadphaseMode == BROADPHASE_AABB_TREE) tree.nodeBounds(debugBounds);
+		for (const Rectangle& bounds : debugBounds) debugDraw.rect(DEBUG_BROADPHASE, bounds, 1, { 102, 191, 255, 100 }); // SKYBLUE, faded
+	}
+}
+
+unsigned int FizziksWorld::stateHash() {
+	const int columns = 5;
+	int grain = hashGrain > 0 ? hashGrain : 1;
+	int chunks = (bodies.size() + grain - 1) / grain;
+	chunkHashes.resize(chunks * columns);
+
+	threads.parallelFor(bodies.size(), grain, [&](int begin, int end, int worker) {
+		unsigned int* hashes = chunkHashes.data() + (begin / grain) * columns;
+		int floatBytes = (end - begin) * (int)sizeof(float);
+		hashes[0] = FizziksCRC32((const unsigned char*)(bodies.positionX.data() + begin), floatBytes);
+		hashes[1] = FizziksCRC32((const unsigned char*)(bodies.positionY.data() + begin), floatBytes);
+		hashes[2] = FizziksCRC32((const unsigned char*)(bodies.velocityX.data() + begin), floatBytes);
+		hashes[3] = FizziksCRC32((const unsigned char*)(bodies.velocityY.data() + begin), floatBytes);
+		hashes[4] = FizziksCRC32(bodies.flags.data() + begin, end - begin);
+	});
+
+	return FizziksCRC32((const unsigned char*)chunkHashes.data(), (int)(chunkHashes.size() * sizeof(unsigned int)));
+}
+
+int FizziksWorld::advance(float frameTime) {
+	accumulator += frameTime;
+
+	float most = maxStepsPerFrame * fixedStep;
+	if (accumulator > most) {
+		droppedTime += accumulator - most;
+		accumulator = most;
+	}
+
+	lastSteps = 0;
+	while (fixedStep > 0 && accumulator >= fixedStep) {
+		bodies.previousX = bodies.positionX;
+		bodies.previousY = bodies.positionY;
+		update(fixedStep);
+		accumulator -= fixedStep;
+		lastSteps++;
+	}
+	return lastSteps;
+}
+
+void FizziksWorld::substep(float deltaTime) {
+	dt = deltaTime;
+
+	{
+		FIZZIKS_PROFILE_SCOPE(profiler, PROFILE_RESET_FORCES);
+		resetNetForces();
+	}
+
+	{
+		FIZZIKS_PROFILE_SCOPE(profiler, PROFILE_GRAVITY);
+		addGravityForces();
+	}
+
+	{
+		FIZZIKS_PROFILE_SCOPE(profiler, PROFILE_COLLISIONS);
+		checkCollisions();
+	}
+
+	{
+		FIZZIKS_PROFILE_SCOPE(profiler, PROFILE_SLEEP);
+		islands.updateSleep(contacts, bodies, dt);
+	}
+
+	{
+		FIZZIKS_PROFILE_SCOPE(profiler, PROFILE_BULLETS);
+		rememberBullets();
+	}
+
+	{
+		FIZZIKS_PROFILE_SCOPE(profiler, PROFILE_KINEMATICS);
+		applyKinematics();
+	}
+
+	{
+		FIZZIKS_PROFILE_SCOPE(profiler, PROFILE_BULLETS);
+		sweepBullets();
+	}
+
+	{
+		FIZZIKS_PROFILE_SCOPE(profiler, PROFILE_CLEANUP);
+		applyBounds();
+		flushDestroyed();
+	}
+}
+
+void FizziksWorld::checkCollisions() {
+	colliding.assign(objekts.size(), 0);
+
+	{
+		FIZZIKS_PROFILE_SCOPE(profiler, PROFILE_BROADPHASE);
+		syncTree();
+		findPairs();
+	}
+
+	int contactsBegin[kernelCount + 1];
+	{
+		FIZZIKS_PROFILE_SCOPE(profiler, PROFILE_NARROWPHASE);
+
+		// sort the pairs into one bucket per kernel so each kernel runs over a batch of
+		// the same shapes, with no shape checks or indirect calls per pair
+		for (const CollisionKernel& kernel : kernels) shapePairs[kernel.first][kernel.second].clear();
+		for (int p = 0; p < pairs.size(); p++) {
+			FizziksPair pair = pairs[p];
+			const CollisionEntry& entry = collisionTable.entries[objekts[pair.a]->Shape()][objekts[pair.b]->Shape()];
+			if (entry.kernel == nullptr) continue;
+			// a sleeping island doesn't need its contacts found again, FizziksIslands remembers them
+			if ((bodies.flags[pair.a] & BODY_NOT_MOVING) && (bodies.flags[pair.b] & BODY_NOT_MOVING)) continue;
+			if (entry.swapped) std::swap(pair.a, pair.b);
+			shapePairs[entry.kernel->first][entry.kernel->second].push_back(pair);
+		}
+
+		// find every contact first (spread over the threads), then resolve them island by island
+		contacts.clear();
+		for (int k = 0; k < kernelCount; k++) {
+			contactsBegin[k] = (int)contacts.size();
+			FIZZIKS_PROFILE_COUNT(profiler, PROFILE_PAIR_TESTS, (int)shapePairs[kernels[k].first][kernels[k].second].size());
+			DetectContacts(*this, kernels[k], shapePairs[kernels[k].first][kernels[k].second]);
+		}
+		contactsBegin[kernelCount] = (int)contacts.size();
+		FIZZIKS_PROFILE_COUNT(profiler, PROFILE_CONTACTS, (int)contacts.size());
+	}
+
+	FIZZIKS_PROFILE_SCOPE(profiler, PROFILE_SOLVER);
+	islands.build(contacts, bodies);
+
+	if (solverMode == SOLVER_IMMEDIATE) {
+		for (int k = 0; k < kernelCount; k++) {
+			kernels[k].resolveBatch(contacts.data() + contactsBegin[k], contactsBegin[k + 1] - contactsBegin[k], *this);
+		}
+	}
+	else {
+		solver.solve(contacts, islands, bodies, dt, threads);
+
+		for (int c = 0; c < contacts.size(); c++) {
+			const FizziksContact& contact = contacts[c];
+			colliding[contact.a] = 1;
+			colliding[contact.b] = 1;
+
+			if (!debugDraw.wants(DEBUG_CONTACTS) || contact.pointCount == 0) continue;
+
+			// impulses over dt, drawn as forces so they line up with the old debug lines
+			Vector2 tangent = { -contact.normal.y, contact.normal.x };
+			Vector2 point = contact.points[0];
+			debugDraw.line(DEBUG_CONTACTS, point, point - contact.normal * (contact.normalImpulse / dt), 1, GREEN);
+			debugDraw.line(DEBUG_CONTACTS, point, point - tangent * (contact.tangentImpulse / dt), 2, ORANGE);
+		}
+	}
+	
+	for (int i = 0; i < objekts.size(); i++) {
+		objekts[i]->color = colliding[i] ? RED : objekts[i]->baseColor;
+	}
+}
+
+void FizziksWorld::findPairs() {
+	pairs.clear();
+	alwaysTest.clear();
+	spatialHash.clear();
+
+	for (int i = 0; i < objekts.size(); i++) {
+		FizziksObjekt* objekt = objekts[i];
+
+		if (objekt->Shape() == HALF_SPACE) alwaysTest.push_back(i);
+		else if (broadphaseMode == BROADPHASE_BRUTE_FORCE || broadphaseMode == BROADPHASE_AABB_TREE) continue; // nothing to insert, or already synced
+		else if (broadphaseMode == BROADPHASE_SWEEP_AND_PRUNE) objekt->broadphaseProxy = sweepAndPrune.update(objekt->broadphaseProxy, i, objekt->getBounds());
+		else spatialHash.insert(i, objekt->getBounds());
+	}
+
+	if (broadphaseMode == BROADPHASE_BRUTE_FORCE) {
+		for (int i = 0; i < objekts.size(); i++) {
+			if (objekts[i]->Shape() == HALF_SPACE) continue;
+			for (int j = i + 1; j < objekts.size(); j++) {
+				if (objekts[j]->Shape() != HALF_SPACE) pairs.push_back({ i, j });
+			}
+		}
+	}
+	else if (broadphaseMode == BROADPHASE_SWEEP_AND_PRUNE) sweepAndPrune.findPairs(pairs);
+	else if (broadphaseMode == BROADPHASE_AABB_TREE) tree.findPairs(pairs);
+	else spatialHash.findPairs(pairs, threads);
+
+	// half-spaces are infinite so they can't go in the grid
+	for (int h = 0; h < alwaysTest.size(); h++) {
+		for (int i = 0; i < objekts.size(); i++) {
+			if (objekts[i]->Shape() == HALF_SPACE) continue;
+			int a = alwaysTest[h] < i ? alwaysTest[h] : i;
+			int b = alwaysTest[h] < i ? i : alwaysTest[h];
+			pairs.push_back({ a, b });
+		}
+	}
+
+	if (!alwaysTest.empty() || deterministic) {
+		std::sort(pairs.begin(), pairs.end(), [](const FizziksPair& l, const FizziksPair& r) {
+			if (l.a != r.a) return l.a < r.a;
+			return l.b < r.b;
+		});
+	}
+
+	candidatePairs = (int)pairs.size();
+}
+
+bool FizziksWorld::testPair(FizziksObjekt* objektPointerA, FizziksObjekt* objektPointerB) {
+	const CollisionEntry& entry = collisionTable.entries[objektPointerA->Shape()][objektPointerB->Shape()];
+	if (entry.kernel == nullptr) return false;
+	if (entry.swapped) return entry.kernel->collide(objektPointerB, objektPointerA, *this);
+	return entry.kernel->collide(objektPointerA, objektPointerB, *this);
+}
+const char* SolverModeName(FizziksSolverMode mode) {
+	switch (mode) {
+	case SOLVER_SEQUENTIAL_IMPULSE: return "sequential impulse";
+	case SOLVER_IMMEDIATE: return "immediate";
+	}
+	return "?";
+}
+
+// table built the first time it's needed, the usual reflected 0xEDB88320 polynomial
+unsigned int FizziksCRC32(const unsigned char* data, int dataSize) {
+	struct Table {
+		unsigned int entries[256];
+
+		Table() {
+			for (unsigned int i = 0; i < 256; i++) {
+				unsigned int crc = i;
+				for (int bit = 0; bit < 8; bit++) crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+				entries[i] = crc;
+			}
+		}
+	};
+	static const Table table;
+
+	unsigned int crc = ~0u;
+	for (int i = 0; i < dataSize; i++) crc = (crc >> 8) ^ table.entries[data[i] ^ (crc & 0xff)];
+	return ~crc;
+}
+
+const char* BroadphaseModeName(FizziksBroadphaseMode mode) {
+	switch (mode) {
+	case BROADPHASE_BRUTE_FORCE: return "brute force";
+	case BROADPHASE_SPATIAL_HASH: return "spatial hash";
+	case BROADPHASE_SWEEP_AND_PRUNE: return "sweep and prune";
+	case BROADPHASE_AABB_TREE: return "aabb tree";
+	}
+	return "?";
+}
+
+// detection. these only read the objekts, so any number of them can run at once
+
+bool CircleCircleContact(const FizziksCircle* circleA, const FizziksCircle* circleB, FizziksContact* contact) {
+	Vector2 positionA = circleA->getPosition();
+	Vector2 displacementFromAToB = circleB->getPosition() - positionA;
+	float distance = Vector2Length(displacementFromAToB);
+	float sumOfRadii = circleA->radius + circleB->radius;
+	float overlap = sumOfRadii - distance;
+
+	if (overlap <= 0) return false;
+
+	Vector2 normalAToB;
+	if (abs(distance) < 0.0001f) {
+		normalAToB = { 0,1 };
+	}
+	else
+		normalAToB = displacementFromAToB / distance;
+
+	contact->normal = normalAToB;
+	contact->depth = overlap;
+	contact->pointCount = 1;
+	contact->points[0] = positionA + normalAToB * (circleA->radius - overlap * 0.5f);
+	return true;
+}
+
+bool CircleHalfspaceContact(const FizziksCircle* circle, const FizziksHalfspace* halfspace, FizziksContact* contact) {
+	Vector2 position = circle->getPosition();
+	Vector2 n = halfspace->getNormal();
+	float dot = Vector2DotProduct(position - halfspace->getPosition(), n);
+	float overlap = circle->radius - dot;
+
+	if (overlap <= 0) return false;
+
+	contact->normal = n * -1; // from the circle into the half-space
+	contact->depth = overlap;
+	contact->pointCount = 1;
+	contact->points[0] = position - n * dot;
+	return true;
+}
+
+bool AABBAABBContact(const FizziksAABB* aabbA, const FizziksAABB* aabbB, FizziksContact* contact) {
+	Vector2 positionA = aabbA->getPosition();
+	Vector2 positionB = aabbB->getPosition();
+
+	Vector2 cA = { positionA.x + aabbA->sizeXY.x * 0.5f, positionA.y + aabbA->sizeXY.y * 0.5f };
+	Vector2 cB = { positionB.x + aabbB->sizeXY.x * 0.5f, positionB.y + aabbB->sizeXY.y * 0.5f };
+
+	float halfWidthA = aabbA->sizeXY.x * 0.5f;
+	float halfWidthB = aabbB->sizeXY.x * 0.5f;
+	float halfHeightA = aabbA->sizeXY.y * 0.5f;
+	float halfHeightB = aabbB->sizeXY.y * 0.5f;
+
+	Vector2 d = { cB.x - cA.x, cB.y - cA.y };
+
+	float overlapX = (halfWidthA + halfWidthB) - fabsf(d.x);
+	float overlapY = (halfHeightA + halfHeightB) - fabsf(d.y);
+
+	if (overlapX <= 0.0f || overlapY <= 0.0f) return false;
+
+	// the overlap region's edge facing along the normal, clipped to both boxes
+	float left = fmaxf(positionA.x, positionB.x);
+	float right = fminf(positionA.x + aabbA->sizeXY.x, positionB.x + aabbB->sizeXY.x);
+	float top = fmaxf(positionA.y, positionB.y);
+	float bottom = fminf(positionA.y + aabbA->sizeXY.y, positionB.y + aabbB->sizeXY.y);
+
+	contact->pointCount = 2;
+	if (overlapX < overlapY) {
+		contact->normal = { (d.x >= 0.0f ? 1.0f : -1.0f), 0.0f };
+		contact->depth = overlapX;
+		float x = d.x >= 0.0f ? left : right;
+		contact->points[0] = { x, top };
+		contact->points[1] = { x, bottom };
+	}
+	else {
+		contact->normal = { 0.0f, (d.y >= 0.0f ? 1.0f : -1.0f) };
+		contact->depth = overlapY;
+		float y = d.y >= 0.0f ? top : bottom;
+		contact->points[0] = { left, y };
+		contact->points[1] = { right, y };
+	}
+	return true;
+}
+
+bool AABBCircleContact(const FizziksAABB* aabb, const FizziksCircle* circle, FizziksContact* contact) {
+	Vector2 aMin = aabb->getPosition();
+	Vector2 aMax = { aMin.x + aabb->sizeXY.x, aMin.y + aabb->sizeXY.y };
+	Vector2 position = circle->getPosition();
+
+	float closestX = fmaxf(aMin.x, fminf(position.x, aMax.x));
+	float closestY = fmaxf(aMin.y, fminf(position.y, aMax.y));
+	Vector2 closestPoint = { closestX, closestY };
+
+	Vector2 displacement = position - closestPoint;
+	float dist = Vector2Length(displacement);
+	float overlap = circle->radius - dist;
+
+	if (overlap <= 0.0f) return false;
+
+	Vector2 normal;
+	if (dist < 0.0001f) {
+		normal = { 0, -1 };
+	}
+	else {
+		normal = displacement / dist;
+	}
+
+	contact->normal = normal;
+	contact->depth = overlap;
+	contact->pointCount = 1;
+	contact->points[0] = closestPoint;
+	return true;
+}
+
+bool AABBHalfspaceContact(const FizziksAABB* aabb, const FizziksHalfspace* halfspace, FizziksContact* contact) {
+	Vector2 position = aabb->getPosition();
+	Vector2 corners[4];
+	corners[0] = position; // top-left
+	corners[1] = { position.x + aabb->sizeXY.x, position.y }; // top-right
+	corners[2] = { position.x, position.y + aabb->sizeXY.y }; // bottom-left
+	corners[3] = { position.x + aabb->sizeXY.x, position.y + aabb->sizeXY.y }; // bottom-right
+
+	Vector2 n = halfspace->getNormal();
+
+	float minDot = FLT_MAX;
+	contact->pointCount = 0;
+	for (int i = 0; i < 4; i++) {
+		float d = Vector2DotProduct(corners[i] - halfspace->getPosition(), n);
+		if (d < minDot) minDot = d;
+		// every corner under the surface is a contact point, an edge lying flat gives two
+		if (d < 0.0f && contact->pointCount < 2) contact->points[contact->pointCount++] = corners[i];
+	}
+
+	if (minDot >= 0.0f) return false;
+
+	contact->normal = n * -1;
+	contact->depth = -minDot;
+	return true;
+}
+
+// time of impact, for bullets. also read only
+
+// origin + motion * t against a box: the fraction it goes in at and that face's normal, pointing
+// the way it's going. false if it misses, or starts inside
+static bool SweepPointBox(Vector2 origin, Vector2 motion, Vector2 boxMin, Vector2 boxMax, float* fraction, Vector2* normal) {
+	float tMin = -FLT_MAX;
+	float tMax = FLT_MAX;
+	int hitAxis = -1;
+	float start[2] = { origin.x, origin.y };
+	float direction[2] = { motion.x, motion.y };
+	float lower[2] = { boxMin.x, boxMin.y };
+	float upper[2] = { boxMax.x, boxMax.y };
+
+	for (int axis = 0; axis < 2; axis++) {
+		if (direction[axis] == 0) {
+			if (start[axis] < lower[axis] || start[axis] > upper[axis]) return false;
+			continue;
+		}
+		float t1 = (lower[axis] - start[axis]) / direction[axis];
+		float t2 = (upper[axis] - start[axis]) / direction[axis];
+		if (t1 > t2) std::swap(t1, t2);
+		if (t1 > tMin) {
+			tMin = t1;
+			hitAxis = axis;
+		}
+		tMax = fminf(tMax, t2);
+	}
+
+	if (hitAxis < 0 || tMin > tMax || tMin < 0 || tMin > 1) return false;
+
+	*fraction = tMin;
+	if (hitAxis == 0) *normal = { motion.x > 0 ? 1.0f : -1.0f, 0 };
+	else *normal = { 0, motion.y > 0 ? 1.0f : -1.0f };
+	return true;
+}
+
+// same against a circle, the normal from the hit point to its centre
+static bool SweepPointCircle(Vector2 origin, Vector2 motion, Vector2 center, float radius, float* fraction, Vector2* normal) {
+	Vector2 f = origin - center;
+	float a = Vector2DotProduct(motion, motion);
+	float b = 2 * Vector2DotProduct(f, motion);
+	float c = Vector2DotProduct(f, f) - radius * radius;
+	if (c <= 0 || a <= 0) return false;
+
+	float discriminant = b * b - 4 * a * c;
+	if (discriminant < 0) return false;
+
+	float t = (-b - sqrtf(discriminant)) / (2 * a);
+	if (t < 0 || t > 1) return false;
+
+	*fraction = t;
+	*normal = Vector2Normalize(center - (origin + motion * t));
+	return true;
+}
+
+// a circle against a box is its centre against the box grown by the radius, with rounded
+// corners: two boxes grown one way each plus a circle on every corner
+static bool SweepCircleBox(Vector2 center, float radius, Vector2 motion, Vector2 boxMin, Vector2 boxMax, float* fraction, Vector2* normal) {
+	float closestX = fmaxf(boxMin.x, fminf(center.x, boxMax.x));
+	float closestY = fmaxf(boxMin.y, fminf(center.y, boxMax.y));
+	if (Vector2DistanceSqr(center, { closestX, closestY }) < radius * radius) return false;
+
+	bool hit = false;
+	float t;
+	Vector2 n;
+	if (SweepPointBox(center, motion, { boxMin.x - radius, boxMin.y }, { boxMax.x + radius, boxMax.y }, &t, &n) && (!hit || t < *fraction)) {
+		*fraction = t;
+		*normal = n;
+		hit = true;
+	}
+	if (SweepPointBox(center, motion, { boxMin.x, boxMin.y - radius }, { boxMax.x, boxMax.y + radius }, &t, &n) && (!hit || t < *fraction)) {
+		*fraction = t;
+		*normal = n;
+		hit = true;
+	}
+
+	Vector2 corners[4] = { boxMin, { boxMax.x, boxMin.y }, { boxMin.x, boxMax.y }, boxMax };
+	for (int i = 0; i < 4; i++) {
+		if (SweepPointCircle(center, motion, corners[i], radius, &t, &n) && (!hit || t < *fraction)) {
+			*fraction = t;
+			*normal = n;
+			hit = true;
+		}
+	}
+	return hit;
+}
+
+// distance is how far the closest point is above the surface
+static bool SweepHalfspace(float distance, Vector2 motion, const FizziksHalfspace* halfspace, float* fraction, Vector2* normal) {
+	Vector2 n = halfspace->getNormal();
+	float approach = -Vector2DotProduct(motion, n);
+	if (distance < 0 || approach <= 0 || distance > approach) return false;
+
+	*fraction = distance / approach;
+	*normal = n * -1;
+	return true;
+}
+
+bool CircleCircleTimeOfImpact(const FizziksCircle* circle, Vector2 start, Vector2 motion, const FizziksCircle* other, float* fraction, Vector2* normal) {
+	return SweepPointCircle(start, motion, other->getPosition(), circle->radius + other->radius, fraction, normal);
+}
+
+bool CircleAABBTimeOfImpact(const FizziksCircle* circle, Vector2 start, Vector2 motion, const FizziksAABB* aabb, float* fraction, Vector2* normal) {
+	Vector2 boxMin = aabb->getPosition();
+	return SweepCircleBox(start, circle->radius, motion, boxMin, boxMin + aabb->sizeXY, fraction, normal);
+}
+
+bool CircleHalfspaceTimeOfImpact(const FizziksCircle* circle, Vector2 start, Vector2 motion, const FizziksHalfspace* halfspace, float* fraction, Vector2* normal) {
+	float distance = Vector2DotProduct(start - halfspace->getPosition(), halfspace->getNormal()) - circle->radius;
+	return SweepHalfspace(distance, motion, halfspace, fraction, normal);
+}
+
+bool AABBAABBTimeOfImpact(const FizziksAABB* aabb, Vector2 start, Vector2 motion, const FizziksAABB* other, float* fraction, Vector2* normal) {
+	// the moving box's corner against the other box grown by its size
+	Vector2 otherMin = other->getPosition();
+	return SweepPointBox(start, motion, otherMin - aabb->sizeXY, otherMin + other->sizeXY, fraction, normal);
+}
+
+bool AABBCircleTimeOfImpact(const FizziksAABB* aabb, Vector2 start, Vector2 motion, const FizziksCircle* circle, float* fraction, Vector2* normal) {
+	// the circle going the other way against the box where it started
+	if (!SweepCircleBox(circle->getPosition(), circle->radius, motion * -1, start, start + aabb->sizeXY, fraction, normal)) return false;
+	*normal = *normal * -1;
+	return true;
+}
+
+bool AABBHalfspaceTimeOfImpact(const FizziksAABB* aabb, Vector2 start, Vector2 motion, const FizziksHalfspace* halfspace, float* fraction, Vector2* normal) {
+	Vector2 n = halfspace->getNormal();
+	Vector2 corners[4] = { start, { start.x + aabb->sizeXY.x, start.y }, { start.x, start.y + aabb->sizeXY.y }, start + aabb->sizeXY };
+	float distance = FLT_MAX;
+	for (int i = 0; i < 4; i++) distance = fminf(distance, Vector2DotProduct(corners[i] - halfspace->getPosition(), n));
+	return SweepHalfspace(distance, motion, halfspace, fraction, normal);
+}
+
+// resolution, one contact at a time in a fixed order. these write positions and velocities
+
+void CircleCircleResolve(FizziksCircle* circleA, FizziksCircle* circleB, const FizziksContact& contact, FizziksWorld& world) {
+	Vector2 normalAToB = contact.normal;
+	Vector2 mtv = normalAToB * contact.depth;
+
+	circleA->setPosition(circleA->getPosition() - mtv * 0.5f);
+	circleB->setPosition(circleB->getPosition() + mtv * 0.5f);
+	
+	//from perspective of A
+	Vector2 velocityBRelativeToA = circleB->getVelocity() - circleA->getVelocity();
+	float closingVelocity1D = Vector2DotProduct(velocityBRelativeToA, normalAToB);
+	//if dot is negative then we are coliding. if positive, not colliding
+	if (closingVelocity1D >= 0) return;
+	
+
+	float restitution = circleA->bounciness * circleB->bounciness;
+
+	float totalMass = circleA->getMass() + circleB->getMass();
+	float impulseMagnitude = ((1.0f + restitution) * closingVelocity1D * circleA->getMass() * circleB->getMass()) / totalMass;
+	//A-->  <-B 
+	Vector2 impulseForA = normalAToB * impulseMagnitude;
+	Vector2 impulseForB = normalAToB * -impulseMagnitude;
+
+	//apply impulse
+	circleA->setVelocity(circleA->getVelocity() + impulseForA / circleA->getMass());
+	circleB->setVelocity(circleB->getVelocity() + impulseForB / circleB->getMass());
+}
+
+void CircleHalfspaceResolve(FizziksCircle* circle, FizziksHalfspace* halfspace, const FizziksContact& contact, FizziksWorld& world) {
+	Vector2 mtv = halfspace->getNormal() * contact.depth;
+
+	circle->setPosition(circle->getPosition() + mtv);
+
+	//get gravity force
+	Vector2 Fgravity = world.accelerationGravity * circle->getMass();
+
+	//apply normal force
+
+	Vector2 FgPerp = halfspace->getNormal() * Vector2DotProduct(Fgravity, halfspace->getNormal());
+	Vector2 Fnormal = FgPerp * -1;
+	circle->setNetForce(circle->getNetForce() + Fnormal);
+	world.debugDraw.line(DEBUG_FORCES, circle->getPosition(), circle->getPosition() + Fnormal, 1, GREEN);
+
+	//friction
+	//f = uN
+	float u = circle->grippiness * halfspace->grippiness;
+	float frictionMagnitude = u * Vector2Length(Fnormal);
+
+	Vector2 FgPara = Fgravity - FgPerp;
+
+	Vector2 frictionDirection;
+	if (FgPara.x > 0) {
+		frictionDirection = Vector2Normalize(FgPara) * -1;
+		frictionMagnitude = Clamp(frictionMagnitude, 0.0f, Vector2Length(FgPara)); // frictionMagnitude cant be more than FgPara
+	}
+	else {
+		frictionDirection = Vector2Normalize(circle->getVelocity()) * -1;
+		frictionMagnitude = Clamp(frictionMagnitude, 0.0f, Vector2Length(circle->getVelocity()));
+	}
+
+	Vector2 Ffriction = frictionDirection * frictionMagnitude;
+
+	circle->setNetForce(circle->getNetForce() + Ffriction);
+	world.debugDraw.line(DEBUG_FORCES, circle->getPosition(), circle->getPosition() + Ffriction, 2, ORANGE);
+
+
+	//Bouncing!
+	//from perspective of A
+	float closingVelocity1D = Vector2DotProduct(circle->getVelocity(), halfspace->getNormal());
+	//if dot is negative then we are coliding. if positive, not colliding
+	if (closingVelocity1D >= -2) return;
+
+	float restitution = circle->bounciness * halfspace->bounciness;
+	circle->setVelocity(circle->getVelocity() + halfspace->getNormal() * closingVelocity1D * -(1.0f + restitution));
+}
+
+void AABBAABBResolve(FizziksAABB* aabbA, FizziksAABB* aabbB, const FizziksContact& contact, FizziksWorld& world) {
+	Vector2 positionA = aabbA->getPosition();
+	Vector2 positionB = aabbB->getPosition();
+	Vector2 velocityA = aabbA->getVelocity();
+	Vector2 velocityB = aabbB->getVelocity();
+	Vector2 forceA = aabbA->getNetForce();
+	Vector2 forceB = aabbB->getNetForce();
+	float massA = aabbA->getMass();
+	float massB = aabbB->getMass();
+	bool staticA = aabbA->isStatic();
+	bool staticB = aabbB->isStatic();
+
+	Vector2 normal = contact.normal;
+	Vector2 tangent = { -normal.y, normal.x };
+	float u = aabbA->grippiness * aabbB->grippiness;
+
+	if (normal.x != 0.0f) {
+		float push = contact.depth * normal.x;
+
+		// Separate objects
+		if (staticA && !staticB) positionB.x += push;
+		else if (!staticA && staticB) positionA.x -= push;
+		else { positionA.x -= push * 0.5f; positionB.x += push * 0.5f; }
+
+		// Swap horizontal velocities
+		if (staticA && !staticB) velocityB.x = 0.0f;
+		else if (!staticA && staticB) velocityA.x = 0.0f;
+		else { float vxA = velocityA.x; float vxB = velocityB.x; velocityA.x = vxB; velocityB.x = vxA; }
+
+		Vector2 relVel = velocityB - velocityA;
+		float relVelT = Vector2DotProduct(relVel, tangent);
+
+		// Max friction = u * min(normal forces)
+		Vector2 FgA = world.accelerationGravity * massA;
+		Vector2 FgB = world.accelerationGravity * massB;
+		Vector2 FnormalA = (normal * -1) * Vector2DotProduct(FgA, normal);
+		Vector2 FnormalB = (normal * -1) * Vector2DotProduct(FgB, normal);
+		float Fmax = u * fmin(Vector2Length(FnormalA), Vector2Length(FnormalB));
+
+		float frictionMag = Clamp(-relVelT * 50.0f, -Fmax, Fmax);
+		Vector2 Ffriction = tangent * frictionMag;
+
+		if (!staticA) forceA -= Ffriction;
+		if (!staticB) forceB += Ffriction;
+
+	}
+	else {
+		float push = contact.depth * normal.y;
+
+		// Separate objects
+		if (staticA && !staticB) positionB.y += push;
+		else if (!staticA && staticB) positionA.y -= push;
+		else { positionA.y -= push * 0.5f; positionB.y += push * 0.5f; }
+
+		// Swap vertical velocities
+		if (staticA && !staticB) velocityB.y = 0.0f;
+		else if (!staticA && staticB) velocityA.y = 0.0f;
+		else { float vyA = velocityA.y; float vyB = velocityB.y; velocityA.y = vyB; velocityB.y = vyA; }
+
+		Vector2 relVel = velocityB - velocityA;
+		float relVelT = Vector2DotProduct(relVel, tangent);
+
+		Vector2 FgA = world.accelerationGravity * massA;
+		Vector2 FgB = world.accelerationGravity * massB;
+		Vector2 FnormalA = (normal * -1) * Vector2DotProduct(FgA, normal);
+		Vector2 FnormalB = (normal * -1) * Vector2DotProduct(FgB, normal);
+		float Fmax = u * fmin(Vector2Length(FnormalA), Vector2Length(FnormalB));
+
+		float frictionMag = Clamp(-relVelT * 50.0f, -Fmax, Fmax);
+		Vector2 Ffriction = tangent * frictionMag;
+
+		if (!staticA && !staticB) {
+			if (normal.y > 0) forceB += Ffriction;
+			else forceA += Ffriction;
+		}
+		else {
+			if (!staticA) forceA -= Ffriction;
+			if (!staticB) forceB += Ffriction;
+		}
+	}
+
+	aabbA->setPosition(positionA);
+	aabbB->setPosition(positionB);
+	aabbA->setVelocity(velocityA);
+	aabbB->setVelocity(velocityB);
+	aabbA->setNetForce(forceA);
+	aabbB->setNetForce(forceB);
+}
+
+void AABBCircleResolve(FizziksAABB* aabb, FizziksCircle* circle, const FizziksContact& contact, FizziksWorld& world) {
+	Vector2 normal = contact.normal;
+	Vector2 mtv = normal * contact.depth;
+
+	if (aabb->isStatic() && !circle->isStatic()) {
+		circle->setPosition(circle->getPosition() + mtv);
+	}
+	else if (!aabb->isStatic() && circle->isStatic()) {
+		aabb->setPosition(aabb->getPosition() - mtv);
+	}
+	else if (!aabb->isStatic() && !circle->isStatic()) {
+		circle->setPosition(circle->getPosition() + mtv * 0.5f);
+		aabb->setPosition(aabb->getPosition() - mtv * 0.5f);
+	}
+
+	Vector2 relVel = circle->getVelocity() - aabb->getVelocity();
+	float closingVel = Vector2DotProduct(relVel, normal);
+
+	if (closingVel < 0.0f) {
+		float e = circle->bounciness * aabb->bounciness;
+		float totalMass = circle->getMass() + aabb->getMass();
+		float impulseMag = -(1.0f + e) * closingVel;
+		if (aabb->isStatic() && !circle->isStatic()) {
+			circle->setVelocity(circle->getVelocity() + normal * (impulseMag));
+		}
+		else if (!aabb->isStatic() && circle->isStatic()) {
+			aabb->setVelocity(aabb->getVelocity() - normal * (impulseMag));
+		}
+		else if (!aabb->isStatic() && !circle->isStatic()) {
+			Vector2 impulseOnCircle = normal * (impulseMag * (aabb->getMass() / totalMass));
+			Vector2 impulseOnAABB = normal * (-impulseMag * (circle->getMass() / totalMass));
+			circle->setVelocity(circle->getVelocity() + impulseOnCircle / circle->getMass());
+			aabb->setVelocity(aabb->getVelocity() + impulseOnAABB / aabb->getMass());
+		}
+	}
+}
+
+void AABBHalfspaceResolve(FizziksAABB* aabb, FizziksHalfspace* halfspace, const FizziksContact& contact, FizziksWorld& world) {
+	Vector2 n = halfspace->getNormal();
+
+	//float velAlongNormal = Vector2DotProduct(aabb->getVelocity(), n);
+	//if (velAlongNormal < 0.0f) { // traveling into the plane
+	//	float e = aabb->bounciness * halfspace->bounciness;
+	//	aabb->setVelocity(aabb->getVelocity() + n * (-(1.0f + e) * velAlongNormal));
+	//}
+
+	if (!aabb->isStatic()) {
+		aabb->setPosition(aabb->getPosition() + n * contact.depth);
+		Vector2 Fgravity = world.accelerationGravity * aabb->getMass();
+		Vector2 FgPerp = n * Vector2DotProduct(Fgravity, n);
+		Vector2 Fnormal = FgPerp * -1;
+		aabb->setNetForce(aabb->getNetForce() + Fnormal);
+		world.debugDraw.line(DEBUG_FORCES, aabb->getPosition(), aabb->getPosition() + Fnormal, 1, GREEN);
+	}
+}
+
+// detect and resolve in one go
+
+bool CircleCircleOverlap(FizziksCircle* circleA, FizziksCircle* circleB, FizziksWorld& world) {
+	FizziksContact contact;
+	if (!CircleCircleContact(circleA, circleB, &contact)) return false;
+	CircleCircleResolve(circleA, circleB, contact, world);
+	return true;
+}
+
+bool CircleHalfspaceOverlap(FizziksCircle* circle, FizziksHalfspace* halfspace, FizziksWorld& world) {
+	FizziksContact contact;
+	if (!CircleHalfspaceContact(circle, halfspace, &contact)) return false;
+	CircleHalfspaceResolve(circle, halfspace, contact, world);
+	return true;
+}
+
+bool AABBAABBOverlap(FizziksAABB* aabbA, FizziksAABB* aabbB, FizziksWorld& world) {
+	FizziksContact contact;
+	if (!AABBAABBContact(aabbA, aabbB, &contact)) return false;
+	AABBAABBResolve(aabbA, aabbB, contact, world);
+	return true;
+}
+
+bool AABBCircleOverlap(FizziksAABB* aabb, FizziksCircle* circle, FizziksWorld& world) {
+	FizziksContact contact;
+	if (!AABBCircleContact(aabb, circle, &contact)) return false;
+	AABBCircleResolve(aabb, circle, contact, world);
+	return true;
+}
+
+bool AABBHalfspaceOverlap(FizziksAABB* aabb, FizziksHalfspace* halfspace, FizziksWorld& world) {
+	FizziksContact contact;
+	if (!AABBHalfspaceContact(aabb, halfspace, &contact)) return false;
+	AABBHalfspaceResolve(aabb, halfspace, contact, world);
+	return true;
+}
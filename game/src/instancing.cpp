@@ -0,0 +1,77 @@
+#include "instancing.h"
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include <algorithm>
+
+bool FizziksInstancedQuads::load(const char* vertexShader, const char* fragmentShader, const float corners[12],
+	int instanceStride, const FizziksInstanceAttribute* instanceAttributes, int instanceAttributeCount) {
+	unload();
+	int version = rlGetVersion();
+	if (version != RL_OPENGL_33 && version != RL_OPENGL_43) return false;
+	if (instanceAttributeCount > (int)(sizeof(attributes) / sizeof(attributes[0]))) return false;
+
+	shader = rlLoadShaderCode(vertexShader, fragmentShader);
+	if (shader == 0) return false;
+	mvpLocation = rlGetLocationUniform(shader, "mvp");
+
+	stride = instanceStride;
+	attributeCount = instanceAttributeCount;
+	std::copy(instanceAttributes, instanceAttributes + instanceAttributeCount, attributes);
+
+	vertexArray = rlLoadVertexArray();
+	rlEnableVertexArray(vertexArray);
+	cornerBuffer = rlLoadVertexBuffer(corners, 12 * sizeof(float), false);
+	rlSetVertexAttribute(0, 2, RL_FLOAT, false, 0, 0);
+	rlEnableVertexAttribute(0);
+	rlDisableVertexArray();
+
+	reserve(1024);
+	return true;
+}
+
+void FizziksInstancedQuads::unload() {
+	if (instanceBuffer != 0) rlUnloadVertexBuffer(instanceBuffer);
+	if (cornerBuffer != 0) rlUnloadVertexBuffer(cornerBuffer);
+	if (vertexArray != 0) rlUnloadVertexArray(vertexArray);
+	if (shader != 0) rlUnloadShaderProgram(shader);
+	instanceBuffer = cornerBuffer = vertexArray = shader = 0;
+	capacity = 0;
+}
+
+// a new instance buffer big enough for count, hooked up to the vertex array in place of the old one
+void FizziksInstancedQuads::reserve(int count) {
+	if (count <= capacity) return;
+	capacity = std::max(count, capacity * 2);
+
+	rlEnableVertexArray(vertexArray);
+	if (instanceBuffer != 0) rlUnloadVertexBuffer(instanceBuffer);
+	instanceBuffer = rlLoadVertexBuffer(nullptr, capacity * stride, true);
+	for (int a = 0; a < attributeCount; a++) {
+		const FizziksInstanceAttribute& attribute = attributes[a];
+		rlSetVertexAttribute(a + 1, attribute.components, attribute.type, attribute.normalized, stride, attribute.offset);
+		rlSetVertexAttributeDivisor(a + 1, 1);
+		rlEnableVertexAttribute(a + 1);
+	}
+	rlDisableVertexArray();
+}
+
+void FizziksInstancedQuads::draw(const void* instances, int count) {
+	if (shader == 0 || count <= 0) return;
+
+	// whatever rlgl has batched up so far has to go first or it'd end up drawn over these
+	rlDrawRenderBatchActive();
+
+	reserve(count);
+	rlUpdateVertexBuffer(instanceBuffer, instances, count * stride, 0);
+
+	rlEnableShader(shader);
+	rlSetUniformMatrix(mvpLocation, MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection()));
+	rlEnableVertexArray(vertexArray);
+	// quads stretched by the shader can wind either way
+	rlDisableBackfaceCulling();
+	rlDrawVertexArrayInstanced(0, 6, count);
+	rlEnableBackfaceCulling();
+	rlDisableVertexArray();
+	rlDisableShader();
+}
@@ -0,0 +1,229 @@
+#include "integrator.h"
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define FIZZIKS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// msvc lets any function use avx2 intrinsics, gcc and clang want it spelled out
+#if defined(FIZZIKS_X86) && (defined(__GNUC__) || defined(__clang__))
+#define FIZZIKS_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define FIZZIKS_TARGET_AVX2
+#endif
+
+static void AddGravityScalar(float* forceX, float* forceY, const float* mass, const unsigned char* flags, int begin, int end, Vector2 g) {
+	for (int i = begin; i < end; i++) {
+		bool isStill = (flags[i] & BODY_NOT_MOVING) != 0;
+		forceX[i] += isStill ? 0.0f : g.x * mass[i];
+		forceY[i] += isStill ? 0.0f : g.y * mass[i];
+	}
+}
+
+static void IntegrateScalar(float* positionX, float* positionY, float* velocityX, float* velocityY,
+	const float* forceX, const float* forceY, const float* inverseMass, const unsigned char* flags, int begin, int end, float dt) {
+	// selected rather than skipped, adding 0 is what the masked lanes do too (a -0 position comes out +0)
+	for (int i = begin; i < end; i++) {
+		bool isStill = (flags[i] & BODY_NOT_MOVING) != 0;
+
+		positionX[i] += isStill ? 0.0f : velocityX[i] * dt;
+		positionY[i] += isStill ? 0.0f : velocityY[i] * dt;
+
+		//a = F/m
+		velocityX[i] += isStill ? 0.0f : forceX[i] * inverseMass[i] * dt;
+		velocityY[i] += isStill ? 0.0f : forceY[i] * inverseMass[i] * dt;
+	}
+}
+
+#ifdef FIZZIKS_X86
+
+// all ones in every lane whose body is neither static nor asleep
+static inline __m128 DynamicMask4(const unsigned char* flags) {
+	int packed;
+	memcpy(&packed, flags, sizeof(packed));
+	__m128i bytes = _mm_cvtsi32_si128(packed);
+	__m128i zero = _mm_setzero_si128();
+	__m128i lanes = _mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero);
+	__m128i isStill = _mm_and_si128(lanes, _mm_set1_epi32(BODY_NOT_MOVING));
+	return _mm_castsi128_ps(_mm_cmpeq_epi32(isStill, zero));
+}
+
+static int AddGravitySSE2(float* forceX, float* forceY, const float* mass, const unsigned char* flags, int count, Vector2 g) {
+	__m128 gx = _mm_set1_ps(g.x);
+	__m128 gy = _mm_set1_ps(g.y);
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128 dynamic = DynamicMask4(flags + i);
+		__m128 m = _mm_loadu_ps(mass + i);
+		__m128 addX = _mm_and_ps(_mm_mul_ps(gx, m), dynamic);
+		__m128 addY = _mm_and_ps(_mm_mul_ps(gy, m), dynamic);
+		_mm_storeu_ps(forceX + i, _mm_add_ps(_mm_loadu_ps(forceX + i), addX));
+		_mm_storeu_ps(forceY + i, _mm_add_ps(_mm_loadu_ps(forceY + i), addY));
+	}
+	return i;
+}
+
+static int IntegrateSSE2(float* positionX, float* positionY, float* velocityX, float* velocityY,
+	const float* forceX, const float* forceY, const float* inverseMass, const unsigned char* flags, int count, float dt) {
+	__m128 step = _mm_set1_ps(dt);
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128 dynamic = DynamicMask4(flags + i);
+		__m128 vx = _mm_loadu_ps(velocityX + i);
+		__m128 vy = _mm_loadu_ps(velocityY + i);
+		__m128 im = _mm_loadu_ps(inverseMass + i);
+
+		__m128 moveX = _mm_and_ps(_mm_mul_ps(vx, step), dynamic);
+		__m128 moveY = _mm_and_ps(_mm_mul_ps(vy, step), dynamic);
+		_mm_storeu_ps(positionX + i, _mm_add_ps(_mm_loadu_ps(positionX + i), moveX));
+		_mm_storeu_ps(positionY + i, _mm_add_ps(_mm_loadu_ps(positionY + i), moveY));
+
+		__m128 accelerateX = _mm_and_ps(_mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(forceX + i), im), step), dynamic);
+		__m128 accelerateY = _mm_and_ps(_mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(forceY + i), im), step), dynamic);
+		_mm_storeu_ps(velocityX + i, _mm_add_ps(vx, accelerateX));
+		_mm_storeu_ps(velocityY + i, _mm_add_ps(vy, accelerateY));
+	}
+	return i;
+}
+
+FIZZIKS_TARGET_AVX2 static inline __m256 DynamicMask8(const unsigned char* flags) {
+	__m256i lanes = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)flags));
+	__m256i isStill = _mm256_and_si256(lanes, _mm256_set1_epi32(BODY_NOT_MOVING));
+	return _mm256_castsi256_ps(_mm256_cmpeq_epi32(isStill, _mm256_setzero_si256()));
+}
+
+FIZZIKS_TARGET_AVX2 static int AddGravityAVX2(float* forceX, float* forceY, const float* mass, const unsigned char* flags, int count, Vector2 g) {
+	__m256 gx = _mm256_set1_ps(g.x);
+	__m256 gy = _mm256_set1_ps(g.y);
+
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256 dynamic = DynamicMask8(flags + i);
+		__m256 m = _mm256_loadu_ps(mass + i);
+		__m256 addX = _mm256_and_ps(_mm256_mul_ps(gx, m), dynamic);
+		__m256 addY = _mm256_and_ps(_mm256_mul_ps(gy, m), dynamic);
+		_mm256_storeu_ps(forceX + i, _mm256_add_ps(_mm256_loadu_ps(forceX + i), addX));
+		_mm256_storeu_ps(forceY + i, _mm256_add_ps(_mm256_loadu_ps(forceY + i), addY));
+	}
+	return i;
+}
+
+// no fma here on purpose, it would round differently from the scalar and sse2 paths
+FIZZIKS_TARGET_AVX2 static int IntegrateAVX2(float* positionX, float* positionY, float* velocityX, float* velocityY,
+	const float* forceX, const float* forceY, const float* inverseMass, const unsigned char* flags, int count, float dt) {
+	__m256 step = _mm256_set1_ps(dt);
+
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256 dynamic = DynamicMask8(flags + i);
+		__m256 vx = _mm256_loadu_ps(velocityX + i);
+		__m256 vy = _mm256_loadu_ps(velocityY + i);
+		__m256 im = _mm256_loadu_ps(inverseMass + i);
+
+		__m256 moveX = _mm256_and_ps(_mm256_mul_ps(vx, step), dynamic);
+		__m256 moveY = _mm256_and_ps(_mm256_mul_ps(vy, step), dynamic);
+		_mm256_storeu_ps(positionX + i, _mm256_add_ps(_mm256_loadu_ps(positionX + i), moveX));
+		_mm256_storeu_ps(positionY + i, _mm256_add_ps(_mm256_loadu_ps(positionY + i), moveY));
+
+		__m256 accelerateX = _mm256_and_ps(_mm256_mul_ps(_mm256_mul_ps(_mm256_loadu_ps(forceX + i), im), step), dynamic);
+		__m256 accelerateY = _mm256_and_ps(_mm256_mul_ps(_mm256_mul_ps(_mm256_loadu_ps(forceY + i), im), step), dynamic);
+		_mm256_storeu_ps(velocityX + i, _mm256_add_ps(vx, accelerateX));
+		_mm256_storeu_ps(velocityY + i, _mm256_add_ps(vy, accelerateY));
+	}
+	return i;
+}
+
+static bool CpuHasAVX2() {
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7) return false;
+
+	__cpuid(info, 1);
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	bool avx = (info[2] & (1 << 28)) != 0;
+	if (!osxsave || !avx) return false;
+
+	// the os has to save the ymm registers across context switches too
+	if ((_xgetbv(0) & 0x6) != 0x6) return false;
+
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+FizziksSimdLevel FizziksBestSimdLevel() {
+#ifdef FIZZIKS_X86
+	static const FizziksSimdLevel best = CpuHasAVX2() ? SIMD_AVX2 : SIMD_SSE2;
+	return best;
+#else
+	return SIMD_SCALAR;
+#endif
+}
+
+const char* FizziksSimdLevelName(FizziksSimdLevel level) {
+	switch (level) {
+	case SIMD_SCALAR: return "scalar";
+	case SIMD_SSE2: return "sse2";
+	case SIMD_AVX2: return "avx2";
+	}
+	return "?";
+}
+
+void FizziksAddGravity(FizziksBodies& bodies, Vector2 accelerationGravity, FizziksSimdLevel level) {
+	FizziksAddGravity(bodies, accelerationGravity, level, 0, bodies.size());
+}
+
+void FizziksAddGravity(FizziksBodies& bodies, Vector2 accelerationGravity, FizziksSimdLevel level, int begin, int end) {
+	int count = end - begin;
+	float* forceX = bodies.forceX.data() + begin;
+	float* forceY = bodies.forceY.data() + begin;
+	const float* mass = bodies.mass.data() + begin;
+	const unsigned char* flags = bodies.flags.data() + begin;
+
+	int done = 0;
+#ifdef FIZZIKS_X86
+	if (level > FizziksBestSimdLevel()) level = FizziksBestSimdLevel();
+	if (level == SIMD_AVX2) done = AddGravityAVX2(forceX, forceY, mass, flags, count, accelerationGravity);
+	else if (level == SIMD_SSE2) done = AddGravitySSE2(forceX, forceY, mass, flags, count, accelerationGravity);
+#endif
+
+	// whatever didn't fill a whole register
+	AddGravityScalar(forceX, forceY, mass, flags, done, count, accelerationGravity);
+}
+
+void FizziksIntegrate(FizziksBodies& bodies, float dt, FizziksSimdLevel level) {
+	FizziksIntegrate(bodies, dt, level, 0, bodies.size());
+}
+
+void FizziksIntegrate(FizziksBodies& bodies, float dt, FizziksSimdLevel level, int begin, int end) {
+	int count = end - begin;
+	float* positionX = bodies.positionX.data() + begin;
+	float* positionY = bodies.positionY.data() + begin;
+	float* velocityX = bodies.velocityX.data() + begin;
+	float* velocityY = bodies.velocityY.data() + begin;
+	const float* forceX = bodies.forceX.data() + begin;
+	const float* forceY = bodies.forceY.data() + begin;
+	const float* inverseMass = bodies.inverseMass.data() + begin;
+	const unsigned char* flags = bodies.flags.data() + begin;
+
+	int done = 0;
+#ifdef FIZZIKS_X86
+	if (level > FizziksBestSimdLevel()) level = FizziksBestSimdLevel();
+	if (level == SIMD_AVX2) done = IntegrateAVX2(positionX, positionY, velocityX, velocityY, forceX, forceY, inverseMass, flags, count, dt);
+	else if (level == SIMD_SSE2) done = IntegrateSSE2(positionX, positionY, velocityX, velocityY, forceX, forceY, inverseMass, flags, count, dt);
+#endif
+
+	IntegrateScalar(positionX, positionY, velocityX, velocityY, forceX, forceY, inverseMass, flags, done, count, dt);
+}
@@ -0,0 +1,217 @@
+#include "islands.h"
+#include <algorithm>
+#include <cmath>
+
+int FizziksIslands::find(int body) {
+	int root = body;
+	while (parent[root] != root) root = parent[root];
+
+	// point everything on the way straight at the root for next time
+	while (parent[body] != root) {
+		int next = parent[body];
+		parent[body] = root;
+		body = next;
+	}
+	return root;
+}
+
+void FizziksIslands::join(int a, int b) {
+	int rootA = find(a);
+	int rootB = find(b);
+	if (rootA == rootB) return;
+
+	// the lower index always ends up the root so the islands come out the same every run
+	if (rootA < rootB) parent[rootB] = rootA;
+	else parent[rootA] = rootB;
+}
+
+void FizziksIslands::build(const std::vector<FizziksContact>& contacts, const FizziksBodies& bodies) {
+	int count = bodies.size();
+	const unsigned char* flags = bodies.flags.data();
+
+	parent.resize(count);
+	for (int i = 0; i < count; i++) parent[i] = i;
+
+	for (int c = 0; c < contacts.size(); c++) {
+		int a = contacts[c].a;
+		int b = contacts[c].b;
+		if ((flags[a] & BODY_STATIC) || (flags[b] & BODY_STATIC)) continue;
+		join(a, b);
+	}
+
+	// one of these may have been woken by hand since, joining it up wakes the rest of its island
+	for (int p = 0; p < sleepingPairs.size(); p++) {
+		int a = bodies.indexOf(sleepingPairs[p].a);
+		int b = bodies.indexOf(sleepingPairs[p].b);
+		if (a >= 0 && b >= 0) join(a, b);
+	}
+
+	// counting sort by root, so each island's bodies sit together in index order
+	islandOf.assign(count, -1);
+	islandBegin.clear();
+	for (int i = 0; i < count; i++) {
+		if (flags[i] & BODY_STATIC) continue;
+		int root = find(i);
+		if (islandOf[root] < 0) {
+			islandOf[root] = (int)islandBegin.size();
+			islandBegin.push_back(0);
+		}
+		islandOf[i] = islandOf[root];
+		islandBegin[islandOf[i]]++;
+	}
+	int islands = (int)islandBegin.size();
+
+	int total = 0;
+	for (int k = 0; k < islands; k++) {
+		int size = islandBegin[k];
+		islandBegin[k] = total;
+		total += size;
+	}
+	islandBegin.push_back(total);
+
+	members.resize(total);
+	cursor.assign(islandBegin.begin(), islandBegin.end() - 1);
+	for (int i = 0; i < count; i++) {
+		if (islandOf[i] >= 0) members[cursor[islandOf[i]]++] = i;
+	}
+
+	// and again for the contacts, each going with whichever of its bodies isn't static
+	contactBegin.assign(islands + 1, 0);
+	for (int c = 0; c < contacts.size(); c++) {
+		int a = contacts[c].a;
+		contactBegin[islandOf[a] >= 0 ? islandOf[a] : islandOf[contacts[c].b]]++;
+	}
+	total = 0;
+	for (int k = 0; k <= islands; k++) {
+		int size = contactBegin[k];
+		contactBegin[k] = total;
+		total += size;
+	}
+
+	contactOrder.resize(contacts.size());
+	cursor.assign(contactBegin.begin(), contactBegin.end() - 1);
+	for (int c = 0; c < contacts.size(); c++) {
+		int a = contacts[c].a;
+		contactOrder[cursor[islandOf[a] >= 0 ? islandOf[a] : islandOf[contacts[c].b]]++] = c;
+	}
+
+	solveOrder.clear();
+	for (int k = 0; k < islands; k++) {
+		if (contactBegin[k + 1] > contactBegin[k]) solveOrder.push_back(k);
+	}
+	std::stable_sort(solveOrder.begin(), solveOrder.end(), [this](int l, int r) {
+		return contactBegin[l + 1] - contactBegin[l] > contactBegin[r + 1] - contactBegin[r];
+	});
+}
+
+void FizziksIslands::updateSleep(const std::vector<FizziksContact>& contacts, FizziksBodies& bodies, float dt) {
+	unsigned char* flags = bodies.flags.data();
+
+	if (!allowSleep) {
+		if (sleeping > 0) wakeAll(bodies);
+		sleepingPairs.clear();
+		return;
+	}
+
+	float sleepSpeedSquared = sleepSpeed * sleepSpeed;
+	for (int i = 0; i < bodies.size(); i++) {
+		if (flags[i] & BODY_NOT_MOVING) continue;
+
+		float speedSquared = bodies.velocityX[i] * bodies.velocityX[i] + bodies.velocityY[i] * bodies.velocityY[i];
+		if (speedSquared < sleepSpeedSquared) bodies.sleepTime[i] += dt;
+		else bodies.sleepTime[i] = 0;
+	}
+
+	sleeping = 0;
+	for (int k = 0; k < islandCount(); k++) {
+		float stillFor = timeToSleep;
+		for (int m = islandBegin[k]; m < islandBegin[k + 1]; m++) {
+			stillFor = fminf(stillFor, bodies.sleepTime[members[m]]);
+		}
+
+		for (int m = islandBegin[k]; m < islandBegin[k + 1]; m++) {
+			int i = members[m];
+			if (stillFor >= timeToSleep) {
+				flags[i] |= BODY_SLEEPING;
+				bodies.velocityX[i] = 0;
+				bodies.velocityY[i] = 0;
+				sleeping++;
+			}
+			else if (flags[i] & BODY_SLEEPING) {
+				bodies.wake(i);
+			}
+		}
+	}
+
+	// pairs still asleep from before, plus the contacts of islands that just fell asleep.
+	// the narrow phase skipped the first lot, so nothing shows up twice
+	nextSleepingPairs.clear();
+	for (int p = 0; p < sleepingPairs.size(); p++) {
+		int a = bodies.indexOf(sleepingPairs[p].a);
+		int b = bodies.indexOf(sleepingPairs[p].b);
+		if (a >= 0 && b >= 0 && (flags[a] & BODY_SLEEPING) && (flags[b] & BODY_SLEEPING)) nextSleepingPairs.push_back(sleepingPairs[p]);
+	}
+	for (int c = 0; c < contacts.size(); c++) {
+		int a = contacts[c].a;
+		int b = contacts[c].b;
+		if ((flags[a] & BODY_SLEEPING) && (flags[b] & BODY_SLEEPING)) nextSleepingPairs.push_back({ bodies.handleAt(a), bodies.handleAt(b) });
+	}
+	sleepingPairs.swap(nextSleepingPairs);
+}
+
+void FizziksIslands::wakeTouching(int index, FizziksBodies& bodies) {
+	FizziksBodyHandle body = bodies.handleAt(index);
+	for (int p = 0; p < sleepingPairs.size(); p++) {
+		const SleepingPair& pair = sleepingPairs[p];
+		FizziksBodyHandle other;
+		if (pair.a.slot == body.slot && pair.a.generation == body.generation) other = pair.b;
+		else if (pair.b.slot == body.slot && pair.b.generation == body.generation) other = pair.a;
+		else continue;
+
+		int i = bodies.indexOf(other);
+		if (i >= 0) bodies.wake(i);
+	}
+}
+
+void FizziksIslands::wakeTouchingDead(FizziksBodies& bodies) {
+	for (int p = 0; p < sleepingPairs.size(); p++) {
+		int a = bodies.indexOf(sleepingPairs[p].a);
+		int b = bodies.indexOf(sleepingPairs[p].b);
+		if (a < 0 || b < 0) continue;
+		if (bodies.flags[a] & BODY_DEAD) bodies.wake(b);
+		if (bodies.flags[b] & BODY_DEAD) bodies.wake(a);
+	}
+}
+
+void FizziksIslands::wakeAll(FizziksBodies& bodies) {
+	for (int i = 0; i < bodies.size(); i++) {
+		if (bodies.flags[i] & BODY_SLEEPING) bodies.wake(i);
+	}
+	sleeping = 0;
+}
+
+void FizziksIslands::saveSleepingPairs(const FizziksBodies& bodies, std::vector<int>& saved) const {
+	saved.clear();
+	for (const SleepingPair& pair : sleepingPairs) {
+		int a = bodies.indexOf(pair.a);
+		int b = bodies.indexOf(pair.b);
+		if (a < 0 || b < 0) continue;
+		saved.push_back(a);
+		saved.push_back(b);
+	}
+}
+
+void FizziksIslands::loadSleepingPairs(const std::vector<int>& saved, const FizziksBodies& bodies) {
+	sleepingPairs.clear();
+	for (int p = 0; p + 1 < saved.size(); p += 2) {
+		int a = saved[p];
+		int b = saved[p + 1];
+		if (a < 0 || a >= bodies.size() || b < 0 || b >= bodies.size()) continue;
+		sleepingPairs.push_back({ bodies.handleAt(a), bodies.handleAt(b) });
+	}
+
+	sleeping = 0;
+	for (int i = 0; i < bodies.size(); i++) {
+		if (bodies.flags[i] & BODY_SLEEPING) sleeping++;
+	}
+}
@@ -5,744 +5,243 @@ See documentation here: https://www.raylib.com/, and examples here: https://www.
 
 #include "raylib.h"
 #include "raymath.h"
+#include "rlgl.h"
 #define RAYGUI_IMPLEMENTATION
 #include "raygui.h"
 #include "game.h"
+#include "fizziks.h"
+#include "scenes.h"
+#include "snapshot.h"
+#include "debugrender.h"
+#include "bodyrender.h"
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <cmath>
 
-const unsigned int TARGET_FPS = 50;
-float dt = 1.0f / TARGET_FPS;
+// drawing runs as fast as this, physics at world.fixedStep whatever the frame rate
+const unsigned int TARGET_FPS = 144;
+const float PHYSICS_HZ = 60;
+// how far back the time slider can go, older snapshots are dropped
+const float REWIND_SECONDS = 240;
 float time = 0;
 
 float restitution = 0.9f;
 float coefficientOfFriction = 1.0f;
 
-enum FizziksShape {
-	CIRCLE,
-	HALF_SPACE,
-	AABB
-};
+float speed = 100;
+float angle = 0;
+float startX = 100;
+float startY = 500;
 
-class FizziksObjekt {
 
-public:
-	bool isStatic = false;
-	Vector2 position = { 0,0 };
-	Vector2 velocity = { 0,0 };
-	float mass = 1; // in kg
-	Vector2 netForce = { 0,0 };
-	float grippiness = 0.5f;
+FizziksWorld world;
+FizziksHalfspace halfspace;
+FizziksDebugRenderer debugRenderer;
+FizziksBodyRenderer bodyRenderer;
+bool instancedBodies = true; // false draws every objekt on its own with DrawObjekt, to compare
 
-	float bounciness = 0.9f; // for determining coefficient of restitution
+// the world after every frame that stepped it over the last REWIND_SECONDS, and the time each was at, for dragging the time slider back
+FizziksSnapshotHistory history;
+std::vector<float> historyTimes;
 
-	std::string name = "objekt";
-	Color color = GREEN;
-	Color baseColor = GREEN;
+bool showProfiler = false;
+const char* traceStatus = "";
 
-	virtual void draw() {
-		DrawCircle(position.x, position.y, 2, color);
+const char* BatchUploadModeName(int mode)
+{
+	switch (mode) {
+	case RL_BATCH_UPLOAD_ORPHAN: return "orphaned";
+	case RL_BATCH_UPLOAD_PERSISTENT: return "persistent mapped";
+	default: return "sub-data";
 	}
+}
 
-	virtual FizziksShape Shape() = 0;
-};
-
-
+void rewind(float to)
+{
+	int index = (int)(std::upper_bound(historyTimes.begin(), historyTimes.end(), to) - historyTimes.begin()) - 1;
+	if (index < 0 || !history.restore(world, index)) return;
+	historyTimes.resize(index + 1);
+	time = historyTimes[index];
+}
 
-class FizziksCircle : public FizziksObjekt {
-public:
-	float radius = 15; // circle radius in pixels
-	std::string tag = "pig";
 
-	void draw() override {
-		DrawCircle(position.x, position.y, radius, color);
-		DrawLineEx(position, position + velocity, 1, color);
+void update()
+{
+	// anything that leaves the screen is gone
+	world.bounds = { 0, 0, (float)GetScreenWidth(), (float)GetScreenHeight() };
+	int steps = world.advance(GetFrameTime());
+	time += steps * world.fixedStep;
+	if (steps > 0) {
+		int dropped = history.record(world);
+		historyTimes.erase(historyTimes.begin(), historyTimes.begin() + dropped);
+		historyTimes.push_back(time);
 	}
+	
 
-	FizziksShape Shape() override
+	if (IsKeyPressed(KEY_SPACE))
 	{
-		return CIRCLE;
+		FizziksCircle* newBird = world.createCircle();
+		newBird->setPosition({ startX, startY });
+		newBird->setVelocity({ speed * cosf(angle * DEG2RAD), -speed * sinf(angle * DEG2RAD) });
+		newBird->bounciness = restitution;
+		newBird->grippiness = coefficientOfFriction;
+		newBird->tag = "bird";
+		newBird->setBullet(true);
 	}
-};
-
-
-class FizziksHalfspace : public FizziksObjekt {
-private:
-	float rotation = 0;
-	Vector2 normal = { 0, -1 };
 
-public:
-
-	void setRotationDegrees(float rotationDegrees) {
-		rotation = rotationDegrees;
-		normal = Vector2Rotate({ 0, -1 }, rotation * DEG2RAD);
+	if (IsKeyPressed(KEY_S))
+	{
+		FizziksAABB* newBird = world.createAABB();
+		newBird->setPosition({ startX, startY });
+		newBird->setVelocity({ speed * cosf(angle * DEG2RAD), -speed * sinf(angle * DEG2RAD) });
 	}
 
-	float getRotation() {
-		return rotation;
+	if (IsKeyPressed(KEY_G)) {
+		world.broadphaseMode = (FizziksBroadphaseMode)((world.broadphaseMode + 1) % (BROADPHASE_AABB_TREE + 1));
 	}
 
-	Vector2 getNormal() {
-		return normal;
+	if (IsKeyPressed(KEY_C)) {
+		world.solverMode = world.solverMode == SOLVER_IMMEDIATE ? SOLVER_SEQUENTIAL_IMPULSE : SOLVER_IMMEDIATE;
 	}
 
-	void draw() override {
-		DrawCircle(position.x, position.y, 8, color);
-
-		DrawLineEx(position, position + normal * 30, 1, color);
-
-		Vector2 parallelToSurface = Vector2Rotate(normal, PI * 0.5f);
-		DrawLineEx(position - parallelToSurface * 4000, position + parallelToSurface * 4000, 1, color);
-	}
-	FizziksShape Shape() override
-	{
-		return HALF_SPACE;
+	if (IsKeyPressed(KEY_X)) {
+		world.substeps = world.substeps >= 4 ? 1 : world.substeps * 2;
 	}
-};
 
-class FizziksAABB : public FizziksObjekt {
-public:
-	Vector2 sizeXY = { 10,10 };
-	Vector2 maxCoords = { position.x + sizeXY.x, position.y + sizeXY.y };
-	
-	void draw() override {
-		DrawRectangle(position.x, position.y, sizeXY.x, sizeXY.y, color);
+	if (IsKeyPressed(KEY_V)) {
+		world.continuousCollision = !world.continuousCollision;
 	}
 
-	FizziksShape Shape() override
-	{
-		return AABB;
+	// 1 to 4 turn the debug line categories on and off
+	for (int c = 0; c < DEBUG_CATEGORY_COUNT; c++) {
+		if (IsKeyPressed(KEY_ONE + c)) world.debugDraw.categories ^= 1u << c;
 	}
-};
 
-bool CircleCircleOverlap(FizziksCircle* circleA, FizziksCircle* circleB);
-bool CircleHalfspaceOverlap(FizziksCircle* circle, FizziksHalfspace* halfspace);
-bool AABBAABBOverlap(FizziksAABB* aabbA, FizziksAABB* aabbB);
-bool AABBCircleOverlap(FizziksAABB* aabb, FizziksCircle* circle);
-bool AABBHalfspaceOverlap(FizziksAABB* aabb, FizziksHalfspace* halfspace);
-
-class FizziksWorld {
-public:
-	std::vector<FizziksObjekt*> objekts;
-
-	Vector2 accelerationGravity = { 0, 50 };
-
-	void add(FizziksObjekt* newObject) {
-		objekts.push_back(newObject);
+	if (IsKeyPressed(KEY_I)) {
+		instancedBodies = !instancedBodies;
 	}
 
-	void resetNetForces() {
-		for (int i = 0; i < objekts.size(); i++) {
-			objekts[i]->netForce = { 0,0 };
-		}
+	if (IsKeyPressed(KEY_P)) {
+		showProfiler = !showProfiler;
 	}
 
-	void addGravityForces() {
-		for (int i = 0; i < objekts.size(); i++) {
-
-			FizziksObjekt* objekt = objekts[i];
-
-			if (objekt->isStatic) continue;
-
-			Vector2 FGravity = accelerationGravity * objekt->mass;
-			objekt->netForce += FGravity;
-			DrawLineEx(objekt->position, objekt->position + FGravity, 1, PURPLE);
-		}
+	// O lets rlgl reorder draws that don't overlap, so the gui's text and boxes go in a few calls
+	if (IsKeyPressed(KEY_O)) {
+		if (rlIsDrawSortingEnabled()) rlDisableDrawSorting();
+		else rlEnableDrawSorting();
 	}
 
-	void applyKinematics() {
-		for (int i = 0; i < objekts.size(); i++) {
-
-			FizziksObjekt* objekt = objekts[i];
-
-			if (objekt->isStatic) continue;
-
-			objekt->position = objekt->position + objekt->velocity * dt;
-
-			Vector2 acceleration = objekt->netForce / objekt->mass; //a = F/m
-
-			objekt->velocity = objekt->velocity + acceleration * dt;
-
-		}
+	// N goes round 1 to 4 batch buffers, to see what the ring saves
+	if (IsKeyPressed(KEY_N)) {
+		rlSetRenderBatchConfig(rlGetRenderBatchBuffers() % 4 + 1, rlGetRenderBatchElements(), rlGetRenderBatchUploadMode());
 	}
 
-	void update() {
-		
-
-		resetNetForces();
-
-		addGravityForces();
-
-		checkCollisions();
-
-		applyKinematics();
-
+	if (IsKeyPressed(KEY_Z)) {
+		world.islands.allowSleep = !world.islands.allowSleep;
 	}
 
-	void checkCollisions() {
-		std::vector<bool> isColliding(objekts.size(), false);
-
-		for (int i = 0; i < objekts.size(); i++) {
-			for (int j = i + 1; j < objekts.size(); j++) {
-
-				FizziksObjekt* objektPointerA = objekts[i];
-				FizziksObjekt* objektPointerB = objekts[j];
-
-				FizziksShape shapeOfA = objektPointerA->Shape();
-				FizziksShape shapeOfB = objektPointerB->Shape();
+	if (IsKeyPressed(KEY_R)) {
+		for (int i = 0; i < world.objekts.size(); i++) {
 
-				if (shapeOfA == CIRCLE && shapeOfB == CIRCLE) {
+			FizziksObjekt* objekt = world.objekts[i];
 
-					if (CircleCircleOverlap((FizziksCircle*)objektPointerA, (FizziksCircle*)objektPointerB)) {
-						isColliding[i] = true;
-						isColliding[j] = true;
-					}
-				}
-				else if (shapeOfA == CIRCLE && shapeOfB == HALF_SPACE) {
-					if (CircleHalfspaceOverlap((FizziksCircle*)objektPointerA, (FizziksHalfspace*)objektPointerB)) {
-						isColliding[i] = true;
-						isColliding[j] = true;
-					}
-				}
-				else if (shapeOfA == HALF_SPACE && shapeOfB == CIRCLE) {
-					if (CircleHalfspaceOverlap((FizziksCircle*)objektPointerB, (FizziksHalfspace*)objektPointerA)) {
-						isColliding[i] = true;
-						isColliding[j] = true;
-					}
-				}
-				else if (shapeOfA == AABB && shapeOfB == AABB) {
-					if (AABBAABBOverlap((FizziksAABB*)objektPointerA, (FizziksAABB*)objektPointerB)) {
-						isColliding[i] = true;
-						isColliding[j] = true;
-					}
-				}
-				else if (shapeOfA == AABB && shapeOfB == CIRCLE) {
-					if (AABBCircleOverlap((FizziksAABB*)objektPointerA, (FizziksCircle*)objektPointerB)) {
-						isColliding[i] = true;
-						isColliding[j] = true;
-					}
-				}
-				else if (shapeOfA == CIRCLE && shapeOfB == AABB) {
-					if (AABBCircleOverlap((FizziksAABB*)objektPointerB, (FizziksCircle*)objektPointerA)) {
-						isColliding[i] = true;
-						isColliding[j] = true;
-					}
-				}
-				else if (shapeOfA == AABB && shapeOfB == HALF_SPACE) {
-					if (AABBHalfspaceOverlap((FizziksAABB*)objektPointerA, (FizziksHalfspace*)objektPointerB)) {
-						isColliding[i] = true;
-						isColliding[j] = true;
-					}
-				}
-				else if (shapeOfA == HALF_SPACE && shapeOfB == AABB) {
-					if (AABBHalfspaceOverlap((FizziksAABB*)objektPointerB, (FizziksHalfspace*)objektPointerA)) {
-						isColliding[i] = true;
-						isColliding[j] = true;
-					}
-				}
+			if (objekt->Shape() != HALF_SPACE)
+			{
+				world.kill(i);
 			}
 		}
-		
-		for (int i = 0; i < objekts.size(); i++) {
-			objekts[i]->color = isColliding[i] ? RED : objekts[i]->baseColor;
-		}
-	}
-};
-
-float speed = 100;
-float angle = 0;
-float startX = 100;
-float startY = 500;
-
-
-FizziksWorld world;
-FizziksHalfspace halfspace;
-
+		world.flushDestroyed();
+		MakeDeleteableObjekts(world);
+	 }
 
-void MakeDeleteableObjekts() {
 	
-	FizziksAABB* aabb = new FizziksAABB();
-	FizziksAABB* aabb1 = new FizziksAABB();
-	FizziksAABB* aabb2 = new FizziksAABB();
-	FizziksAABB* aabb3 = new FizziksAABB();
-	FizziksAABB* aabb4 = new FizziksAABB();
-	FizziksAABB* aabb5 = new FizziksAABB();
-	FizziksAABB* aabb6 = new FizziksAABB();
-	FizziksAABB* aabb7 = new FizziksAABB();
-
-	FizziksCircle* c1 = new FizziksCircle();
-	c1->position = { 550, 635 };
-	world.add(c1);
-
-	FizziksCircle* c2 = new FizziksCircle();
-	c2->position = { 750, 635 };
-	world.add(c2);
-
-	FizziksCircle* c3 = new FizziksCircle();
-	c3->position = { 650, 285 };
-	world.add(c3);
-
-	aabb->position = { 0, 650 };
-	aabb->sizeXY = { 2000, 50 };
-	aabb->velocity = { 0, 0 };
-	aabb->color = BLUE;
-	aabb->baseColor = BLUE;
-	aabb->isStatic = true;
-	world.add(aabb);
-
-	aabb1->position = { 450, 550 };
-	aabb1->sizeXY = { 50, 100 };
-	aabb1->velocity = { 0, 0 };
-	aabb1->color = GREEN;
-	aabb1->baseColor = GREEN;
-	aabb1->mass = 1;
-	world.add(aabb1);
-
-	aabb2->position = { 450, 450 };
-	aabb2->sizeXY = { 50, 100 };
-	aabb2->velocity = { 0, 0 };
-	aabb2->color = YELLOW;
-	aabb2->baseColor = YELLOW;
-	aabb2->mass = 1;
-	world.add(aabb2);
-
-	aabb3->position = { 450, 350 };
-	aabb3->sizeXY = { 50, 100 };
-	aabb3->velocity = { 0, 0 };
-	aabb3->color = ORANGE;
-	aabb3->baseColor = ORANGE;
-	aabb3->mass = 1;
-	world.add(aabb3);
-
-	aabb4->position = { 450, 300 };
-	aabb4->sizeXY = { 400, 50 };
-	aabb4->velocity = { 0, 0 };
-	aabb4->color = ORANGE;
-	aabb4->baseColor = ORANGE;
-	aabb4->mass = 1;
-	world.add(aabb4);
-
-	aabb5->position = { 800, 550 };
-	aabb5->sizeXY = { 50, 100 };
-	aabb5->velocity = { 0, 0 };
-	aabb5->color = GREEN;
-	aabb5->baseColor = GREEN;
-	aabb5->mass = 1;
-	world.add(aabb5);
-
-	aabb6->position = { 800, 450 };
-	aabb6->sizeXY = { 50, 100 };
-	aabb6->velocity = { 0, 0 };
-	aabb6->color = YELLOW;
-	aabb6->baseColor = YELLOW;
-	aabb6->mass = 1;
-	world.add(aabb6);
-
-	aabb7->position = { 800, 350 };
-	aabb7->sizeXY = { 50, 100 };
-	aabb7->velocity = { 0, 0 };
-	aabb7->color = ORANGE;
-	aabb7->baseColor = ORANGE;
-	aabb7->mass = 1;
-	world.add(aabb7);
-
 
 }
-
-
-bool CircleCircleOverlap(FizziksCircle* circleA, FizziksCircle* circleB) {
-	Vector2 displacementFromAToB = circleB->position - circleA->position;
-	float distance = Vector2Length(displacementFromAToB);
-	float sumOfRadii = circleA->radius + circleB->radius;
-	float overlap = sumOfRadii - distance;
-
-
-	if (overlap > 0) {
-		Vector2 normalAToB;
-		if (abs(distance) < 0.0001f) {
-			normalAToB = { 0,1 };
-		}
-		else
-			normalAToB = displacementFromAToB / distance;
-
-		Vector2 mtv = normalAToB * overlap;
-
-		circleA->position -= mtv * 0.5f;
-		circleB->position += mtv * 0.5f;
-		
-		//from perspective of A
-		Vector2 velocityBRelativeToA = circleB->velocity - circleA->velocity;
-		float closingVelocity1D = Vector2DotProduct(velocityBRelativeToA, normalAToB);
-		//if dot is negative then we are coliding. if positive, not colliding
-		if (closingVelocity1D >= 0) return true;
-		
-
-		float restitution = circleA->bounciness * circleB->bounciness;
-
-		float totalMass = circleA->mass + circleB->mass;
-		float impulseMagnitude = ((1.0f + restitution) * closingVelocity1D * circleA->mass * circleB->mass) / totalMass;
-		//A-->  <-B 
-		Vector2 impulseForA = normalAToB * impulseMagnitude;
-		Vector2 impulseForB = normalAToB * -impulseMagnitude;
-
-		//apply impulse
-		circleA->velocity += impulseForA / circleA->mass;
-		circleB->velocity += impulseForB / circleB->mass;
-
-		return true;
+void DrawObjekt(FizziksObjekt* objekt) {
+	// between the last two physics steps, however far through the next one this frame is
+	Vector2 position = objekt->getInterpolatedPosition(world.interpolation());
+	// sleeping ones are drawn darker
+	Color color = objekt->isSleeping() ? ColorBrightness(objekt->color, -0.5f) : objekt->color;
+
+	switch (objekt->Shape()) {
+	case CIRCLE: {
+		FizziksCircle* circle = (FizziksCircle*)objekt;
+		DrawCircle(position.x, position.y, circle->radius, color);
+		DrawLineEx(position, position + circle->getVelocity(), 1, color);
+		break;
 	}
-	else
-		return false;
-}
-
-bool CircleHalfspaceOverlap(FizziksCircle* circle, FizziksHalfspace* halfspace) {
-
-	Vector2 displacementToCircle = circle->position - halfspace->position;
-
-	float dot = Vector2DotProduct(displacementToCircle, halfspace->getNormal());
-	Vector2 vectorProjection = halfspace->getNormal() * dot;
-
+	case HALF_SPACE: {
+		FizziksHalfspace* halfspace = (FizziksHalfspace*)objekt;
+		DrawCircle(position.x, position.y, 8, halfspace->color);
 
-	Vector2 midpoint = circle->position - vectorProjection * 0.5f;
+		DrawLineEx(position, position + halfspace->getNormal() * 30, 1, halfspace->color);
 
-	float overlap = circle->radius - dot;
-
-
-	if (overlap > 0) {
-		Vector2 normalAToB = (vectorProjection / dot);
-		Vector2 mtv = normalAToB * overlap;
-
-		circle->position += mtv;
-
-		//get gravity force
-		Vector2 Fgravity = world.accelerationGravity * circle->mass;
-
-		//apply normal force
-
-		Vector2 FgPerp = halfspace->getNormal() * Vector2DotProduct(Fgravity, halfspace->getNormal());
-		Vector2 Fnormal = FgPerp * -1;
-		circle->netForce += Fnormal;
-		DrawLineEx(circle->position, circle->position + Fnormal, 1, GREEN);
-
-		//friction
-		//f = uN
-		float u = circle->grippiness * halfspace->grippiness;
-		float frictionMagnitude = u * Vector2Length(Fnormal);
-
-		Vector2 FgPara = Fgravity - FgPerp;
-
-		Vector2 frictionDirection;
-		if (FgPara.x > 0) {
-			frictionDirection = Vector2Normalize(FgPara) * -1;
-			frictionMagnitude = Clamp(frictionMagnitude, 0.0f, Vector2Length(FgPara)); // frictionMagnitude cant be more than FgPara
-		}
-		else {
-			frictionDirection = Vector2Normalize(circle->velocity) * -1;
-			frictionMagnitude = Clamp(frictionMagnitude, 0.0f, Vector2Length(circle->velocity));
-		}
-
-		
-		
-
-		Vector2 Ffriction = frictionDirection * frictionMagnitude;
-
-		circle->netForce += Ffriction;
-		DrawLineEx(circle->position, circle->position + Ffriction, 2, ORANGE);
-
-
-		//Bouncing!
-		//from perspective of A
-		float closingVelocity1D = Vector2DotProduct(circle->velocity, halfspace->getNormal());
-		//if dot is negative then we are coliding. if positive, not colliding
-		if (closingVelocity1D >= -2) return true;
-
-		float restitution = circle->bounciness * halfspace->bounciness;
-		circle->velocity += halfspace->getNormal() * closingVelocity1D * -(1.0f + restitution);
-		
-
-
-		return true;
+		Vector2 parallelToSurface = Vector2Rotate(halfspace->getNormal(), PI * 0.5f);
+		DrawLineEx(position - parallelToSurface * 4000, position + parallelToSurface * 4000, 1, halfspace->color);
+		break;
 	}
-	else return false;
-}
-
-
-bool AABBAABBOverlap(FizziksAABB* aabbA, FizziksAABB* aabbB) {
-	Vector2 cA = { aabbA->position.x + aabbA->sizeXY.x * 0.5f, aabbA->position.y + aabbA->sizeXY.y * 0.5f };
-	Vector2 cB = { aabbB->position.x + aabbB->sizeXY.x * 0.5f, aabbB->position.y + aabbB->sizeXY.y * 0.5f };
-
-	float halfWidthA = aabbA->sizeXY.x * 0.5f;
-	float halfWidthB = aabbB->sizeXY.x * 0.5f;
-	float halfHeightA = aabbA->sizeXY.y * 0.5f;
-	float halfHeightB = aabbB->sizeXY.y * 0.5f;
-
-	Vector2 d = { cB.x - cA.x, cB.y - cA.y };
-
-	float overlapX = (halfWidthA + halfWidthB) - fabsf(d.x);
-	float overlapY = (halfHeightA + halfHeightB) - fabsf(d.y);
-
-	if (overlapX > 0.0f && overlapY > 0.0f) {
-		bool separateOnX = overlapX < overlapY;
-
-		if (separateOnX) {
-			float sign = (d.x >= 0.0f) ? 1.0f : -1.0f;
-			float push = overlapX * sign;
-
-			// Separate objects
-			if (aabbA->isStatic && !aabbB->isStatic) aabbB->position.x += push;
-			else if (!aabbA->isStatic && aabbB->isStatic) aabbA->position.x -= push;
-			else { aabbA->position.x -= push * 0.5f; aabbB->position.x += push * 0.5f; }
-
-			// Swap horizontal velocities
-			if (aabbA->isStatic && !aabbB->isStatic) aabbB->velocity.x = 0.0f;
-			else if (!aabbA->isStatic && aabbB->isStatic) aabbA->velocity.x = 0.0f;
-			else { float vxA = aabbA->velocity.x; float vxB = aabbB->velocity.x; aabbA->velocity.x = vxB; aabbB->velocity.x = vxA; }
-
-			Vector2 normal = { (d.x >= 0.0f ? 1.0f : -1.0f), 0.0f };
-			Vector2 tangent = { -normal.y, normal.x }; 
-
-			Vector2 relVel = aabbB->velocity - aabbA->velocity;
-			float relVelT = Vector2DotProduct(relVel, tangent);
-
-			float u = aabbA->grippiness * aabbB->grippiness;
-
-			// Max friction = u * min(normal forces)
-			Vector2 FgA = world.accelerationGravity * aabbA->mass;
-			Vector2 FgB = world.accelerationGravity * aabbB->mass;
-			Vector2 FnormalA = (normal * -1) * Vector2DotProduct(FgA, normal);
-			Vector2 FnormalB = (normal * -1) * Vector2DotProduct(FgB, normal);
-			float Fmax = u * fmin(Vector2Length(FnormalA), Vector2Length(FnormalB));
-
-			float frictionMag = Clamp(-relVelT * 50.0f, -Fmax, Fmax);
-			Vector2 Ffriction = tangent * frictionMag;
-
-			if (!aabbA->isStatic) aabbA->netForce -= Ffriction;
-			if (!aabbB->isStatic) aabbB->netForce += Ffriction;
-
-		}
-		else {
-			float sign = (d.y >= 0.0f) ? 1.0f : -1.0f;
-			float push = overlapY * sign;
-
-			// Separate objects
-			if (aabbA->isStatic && !aabbB->isStatic) aabbB->position.y += push;
-			else if (!aabbA->isStatic && aabbB->isStatic) aabbA->position.y -= push;
-			else { aabbA->position.y -= push * 0.5f; aabbB->position.y += push * 0.5f; }
-
-			// Swap vertical velocities
-			if (aabbA->isStatic && !aabbB->isStatic) aabbB->velocity.y = 0.0f;
-			else if (!aabbA->isStatic && aabbB->isStatic) aabbA->velocity.y = 0.0f;
-			else { float vyA = aabbA->velocity.y; float vyB = aabbB->velocity.y; aabbA->velocity.y = vyB; aabbB->velocity.y = vyA; }
-
-			Vector2 normal = { 0.0f, (d.y >= 0.0f ? 1.0f : -1.0f) };
-			Vector2 tangent = { -normal.y, normal.x };
-
-			Vector2 relVel = aabbB->velocity - aabbA->velocity;
-			float relVelT = Vector2DotProduct(relVel, tangent);
-
-			float u = aabbA->grippiness * aabbB->grippiness;
-
-			Vector2 FgA = world.accelerationGravity * aabbA->mass;
-			Vector2 FgB = world.accelerationGravity * aabbB->mass;
-			Vector2 FnormalA = (normal * -1) * Vector2DotProduct(FgA, normal);
-			Vector2 FnormalB = (normal * -1) * Vector2DotProduct(FgB, normal);
-			float Fmax = u * fmin(Vector2Length(FnormalA), Vector2Length(FnormalB));
-
-			float frictionMag = Clamp(-relVelT * 50.0f, -Fmax, Fmax);
-			Vector2 Ffriction = tangent * frictionMag;
-
-			if (!aabbA->isStatic && !aabbB->isStatic) {
-				if (d.y > 0) aabbB->netForce += Ffriction;
-				else aabbA->netForce += Ffriction;
-			}
-			else {
-				if (!aabbA->isStatic) aabbA->netForce -= Ffriction;
-				if (!aabbB->isStatic) aabbB->netForce += Ffriction;
-			}
-		}
-
-		return true;
+	case AABB: {
+		FizziksAABB* aabb = (FizziksAABB*)objekt;
+		DrawRectangle(position.x, position.y, aabb->sizeXY.x, aabb->sizeXY.y, color);
+		break;
 	}
-
-	return false;
-}
-
-bool AABBCircleOverlap(FizziksAABB* aabb, FizziksCircle* circle) {
-	Vector2 aMin = aabb->position;
-	Vector2 aMax = { aabb->position.x + aabb->sizeXY.x, aabb->position.y + aabb->sizeXY.y };
-
-	float closestX = fmaxf(aMin.x, fminf(circle->position.x, aMax.x));
-	float closestY = fmaxf(aMin.y, fminf(circle->position.y, aMax.y));
-	Vector2 closestPoint = { closestX, closestY };
-
-	Vector2 displacement = circle->position - closestPoint;
-	float dist = Vector2Length(displacement);
-	float overlap = circle->radius - dist;
-
-	if (overlap > 0.0f) {
-		Vector2 normal;
-		if (dist < 0.0001f) {
-			normal = { 0, -1 };
-		}
-		else {
-			normal = displacement / dist;
-		}
-
-		Vector2 mtv = normal * overlap;
-
-		if (aabb->isStatic && !circle->isStatic) {
-			circle->position += mtv;
-		}
-		else if (!aabb->isStatic && circle->isStatic) {
-			aabb->position -= mtv;
-		}
-		else if (!aabb->isStatic && !circle->isStatic) {
-			circle->position += mtv * 0.5f;
-			aabb->position -= mtv * 0.5f;
-		}
-		else {
-			
-		}
-
-		Vector2 relVel = circle->velocity - aabb->velocity;
-		float closingVel = Vector2DotProduct(relVel, normal);
-
-		if (closingVel < 0.0f) {
-			float e = circle->bounciness * aabb->bounciness;
-			float totalMass = circle->mass + aabb->mass;
-			float impulseMag = -(1.0f + e) * closingVel;
-			if (aabb->isStatic && !circle->isStatic) {
-				circle->velocity += normal * (impulseMag);
-			}
-			else if (!aabb->isStatic && circle->isStatic) {
-				aabb->velocity -= normal * (impulseMag);
-			}
-			else if (!aabb->isStatic && !circle->isStatic) {
-				Vector2 impulseOnCircle = normal * (impulseMag * (aabb->mass / totalMass));
-				Vector2 impulseOnAABB = normal * (-impulseMag * (circle->mass / totalMass));
-				circle->velocity += impulseOnCircle / circle->mass;
-				aabb->velocity += impulseOnAABB / aabb->mass;
-			}
-		}
-		return true;
+	default:
+		break;
 	}
-	return false;
 }
 
+// the stages that don't have any inside them, stacked up per step
+const FizziksProfileStage profiledStages[] = {
+	PROFILE_RESET_FORCES, PROFILE_GRAVITY, PROFILE_BROADPHASE, PROFILE_NARROWPHASE, PROFILE_SOLVER,
+	PROFILE_SLEEP, PROFILE_BULLETS, PROFILE_KINEMATICS, PROFILE_CLEANUP, PROFILE_HASH
+};
+const Color profiledColors[] = { GRAY, PURPLE, SKYBLUE, GREEN, ORANGE, DARKBLUE, YELLOW, PINK, BROWN, LIME };
 
-bool AABBHalfspaceOverlap(FizziksAABB* aabb, FizziksHalfspace* halfspace) {
-	Vector2 corners[4];
-	corners[0] = aabb->position; // top-left
-	corners[1] = { aabb->position.x + aabb->sizeXY.x, aabb->position.y }; // top-right
-	corners[2] = { aabb->position.x, aabb->position.y + aabb->sizeXY.y }; // bottom-left
-	corners[3] = { aabb->position.x + aabb->sizeXY.x, aabb->position.y + aabb->sizeXY.y }; // bottom-right
-
-	Vector2 n = halfspace->getNormal();
-
-	float minDot = FLT_MAX;
-	for (int i = 0; i < 4; i++) {
-		float d = Vector2DotProduct(corners[i] - halfspace->position, n);
-		if (d < minDot) minDot = d;
-	}
-
-	if (minDot < 0.0f) {
-		float overlap = -minDot;
-
-		//float velAlongNormal = Vector2DotProduct(aabb->velocity, n);
-		//if (velAlongNormal < 0.0f) { // traveling into the plane
-		//	float e = aabb->bounciness * halfspace->bounciness;
-		//	aabb->velocity += n * (-(1.0f + e) * velAlongNormal);
-		//}
-
-		if (!aabb->isStatic) {
-			aabb->position += n * overlap;
-			Vector2 Fgravity = world.accelerationGravity * aabb->mass;
-			Vector2 FgPerp = n * Vector2DotProduct(Fgravity, n);
-			Vector2 Fnormal = FgPerp * -1;
-			aabb->netForce += Fnormal;
-			DrawLineEx(aabb->position, aabb->position + Fnormal, 1, GREEN);
+// one bar per physics step, as tall as the step took against the time it's meant to fit in
+void drawProfiler()
+{
+	const FizziksProfiler& profiler = world.profiler;
+	Rectangle panel = { 10, (float)GetScreenHeight() - 300, 560, 260 };
+	GuiPanel(panel, "physics profile");
+
+	Rectangle graph = { panel.x + 10, panel.y + 35, panel.width - 20, 120 };
+	float budgetMs = world.fixedStep * 1000;
+	float barWidth = graph.width / profiler.historyLength();
+	DrawRectangleLinesEx(graph, 1, DARKGRAY);
+	for (int ago = 0; ago < profiler.frameCount(); ago++) {
+		const FizziksProfileFrame& frame = profiler.frame(ago);
+		float x = graph.x + graph.width - (ago + 1) * barWidth;
+		float y = graph.y + graph.height;
+		for (int s = 0; s < sizeof(profiledStages) / sizeof(profiledStages[0]); s++) {
+			float height = (float)frame.stageSeconds[profiledStages[s]] * 1000 / budgetMs * graph.height;
+			height = std::min(height, y - graph.y);
+			DrawRectangleRec({ x, y - height, std::max(barWidth, 1.0f), height }, profiledColors[s]);
+			y -= height;
 		}
-
-		return true;
 	}
-
-	return false;
-}
-
-void cleanup() {
-
-	for (int i = 0; i < world.objekts.size(); i++) {
-
-		FizziksObjekt* objekt = world.objekts[i];
-
-		if (	objekt->position.y > GetScreenHeight()
-			||	objekt->position.y < 0
-			||	objekt->position.x > GetScreenWidth()
-			||	objekt->position.x < 0
-			)
-		{
-			auto iterator = (world.objekts.begin() + i);
-			FizziksObjekt* pointerToFizziksObjekt = *iterator;
-			delete pointerToFizziksObjekt;
-
-			world.objekts.erase(iterator);
-			i--;
-		}
+	DrawText(TextFormat("%.1f ms", budgetMs), graph.x + 2, graph.y + 2, 10, LIGHTGRAY);
+
+	for (int s = 0; s < sizeof(profiledStages) / sizeof(profiledStages[0]); s++) {
+		float x = graph.x + (s % 2) * 270;
+		float y = graph.y + graph.height + 8 + (s / 2) * 13;
+		DrawRectangle(x, y, 8, 8, profiledColors[s]);
+		float lastMs = profiler.frameCount() > 0 ? (float)profiler.frame(0).stageSeconds[profiledStages[s]] * 1000 : 0;
+		DrawText(TextFormat("%s: %.3f ms, avg %.3f", FizziksProfileStageName(profiledStages[s]), lastMs, profiler.averageSeconds(profiledStages[s]) * 1000), x + 12, y - 1, 10, LIGHTGRAY);
 	}
-}
-
-void update()
-{
-	dt = 1.0f / TARGET_FPS;
-	time += dt;
-
-	cleanup();
-	world.update();
-	
-
-	if (IsKeyPressed(KEY_SPACE))
-	{
-		FizziksCircle* newBird = new FizziksCircle();
-		newBird->position = { startX, startY };
-		newBird->velocity = { speed * (float)cos(angle * DEG2RAD), -speed * (float)sin(angle * DEG2RAD) };
-		newBird->bounciness = restitution;
-		newBird->grippiness = coefficientOfFriction;
-		newBird->tag = "bird";
 
-		world.add(newBird);
+	if (profiler.frameCount() > 0) {
+		const FizziksProfileFrame& last = profiler.frame(0);
+		DrawText(TextFormat("step %.3f ms, %d pair tests, %d contacts, %d active bodies", last.stageSeconds[PROFILE_UPDATE] * 1000,
+			last.counters[PROFILE_PAIR_TESTS], last.counters[PROFILE_CONTACTS], last.counters[PROFILE_ACTIVE_BODIES]), graph.x, panel.y + panel.height - 18, 10, LIGHTGRAY);
 	}
 
-	if (IsKeyPressed(KEY_S))
-	{
-		FizziksAABB* newBird = new FizziksAABB();
-		newBird->position = { startX, startY };
-		newBird->velocity = { speed * (float)cos(angle * DEG2RAD), -speed * (float)sin(angle * DEG2RAD) };
-
-		world.add(newBird);
+	if (GuiButton({ panel.x + panel.width - 130, panel.y + panel.height - 24, 120, 18 }, "export chrome trace")) {
+		traceStatus = world.profiler.writeChromeTrace("physics-trace.json") ? "wrote physics-trace.json" : "couldn't write physics-trace.json";
 	}
-
-	if (IsKeyPressed(KEY_R)) {
-		for (int i = 0; i < world.objekts.size(); i++) {
-
-			FizziksObjekt* objekt = world.objekts[i];
-
-			if (objekt->Shape() != HALF_SPACE)
-			{
-				auto iterator = (world.objekts.begin() + i);
-				FizziksObjekt* pointerToFizziksObjekt = *iterator;
-				delete pointerToFizziksObjekt;
-
-				world.objekts.erase(iterator);
-				i--;
-			}
-		}
-		MakeDeleteableObjekts();
-	 }
-
-	
-
+	DrawText(traceStatus, graph.x + graph.width - MeasureText(traceStatus, 10), graph.y - 11, 10, LIGHTGRAY);
 }
+
 void draw()
 {
 	BeginDrawing();
@@ -751,7 +250,13 @@ void draw()
 	
 
 
-	GuiSliderBar(Rectangle{ 100, 10, 800, 20 }, "", TextFormat("%.2f", time), &time, 0, 240);
+	// only backwards, there's nothing recorded ahead of now, so the slider ends at the newest snapshot
+	float oldTime = time;
+	float oldestTime = historyTimes.empty() ? 0 : historyTimes.front();
+	float newestTime = historyTimes.empty() ? time : historyTimes.back();
+	GuiSliderBar(Rectangle{ 100, 10, 800, 20 }, "", TextFormat("%.2f", time), &time, oldestTime, fmaxf(newestTime, oldestTime + world.fixedStep));
+	if (time < fminf(oldTime, newestTime)) rewind(time);
+	else time = oldTime;
 
 	GuiSliderBar(Rectangle{ 100, 30, 800, 20 }, "Speed", TextFormat("Speed: %.0f", speed), &speed, -1000, 1000);
 
@@ -761,22 +266,58 @@ void draw()
 
 	GuiSliderBar(Rectangle{ 700, 70, 400, 20 }, "StartPosY", TextFormat("StartPosY: %.0f", startY), &startY, 0, GetScreenHeight());
 
+	float gravityY = world.accelerationGravity.y;
 	GuiSliderBar(Rectangle{ 100, 90, 800, 20 }, "Gravity Y", TextFormat("Gravity Y: %.0f Px/sec^2", world.accelerationGravity.y), &world.accelerationGravity.y, -1000, 1000);
 
 	DrawText(TextFormat("T: %3.2f", time), GetScreenWidth() - 150, 5, 30, LIGHTGRAY);
 
+	DrawText(TextFormat("[G] broad phase: %s", BroadphaseModeName(world.broadphaseMode)), GetScreenWidth() - 280, 40, 10, LIGHTGRAY);
+	DrawText(TextFormat("pairs tested: %d", world.candidatePairs), GetScreenWidth() - 280, 55, 10, LIGHTGRAY);
+	DrawText(TextFormat("[X] physics: %.0f Hz x %d substeps, %d steps this frame", 1.0f / world.fixedStep, world.substeps, world.lastSteps), GetScreenWidth() - 280, 100, 10, LIGHTGRAY);
+	DrawText(TextFormat("[Z] sleeping: %s, %d asleep in %d islands", world.islands.allowSleep ? "on" : "off", world.islands.sleepingCount(), world.islands.islandCount()), GetScreenWidth() - 280, 85, 10, LIGHTGRAY);
+	DrawText(TextFormat("[V] bullet sweeps: %s, %d hits", world.continuousCollision ? "on" : "off", world.bulletHits), GetScreenWidth() - 280, 115, 10, LIGHTGRAY);
+	DrawText(TextFormat("state hash: %08x", world.frameHash), GetScreenWidth() - 280, 145, 10, LIGHTGRAY);
+	DrawText(TextFormat("[P] profiler: %s", showProfiler ? "on" : "off"), GetScreenWidth() - 280, 160, 10, LIGHTGRAY);
+	std::string debugCategories;
+	for (int c = 0; c < DEBUG_CATEGORY_COUNT; c++) {
+		if (world.debugDraw.wants((FizziksDebugCategory)(1 << c))) debugCategories += std::string(debugCategories.empty() ? "" : ", ") + FizziksDebugCategoryName((FizziksDebugCategory)(1 << c));
+	}
+	DrawText(TextFormat("[I] bodies: %s, %d circles and %d boxes drawn", instancedBodies ? (bodyRenderer.instanced() ? "instanced" : "batched fallback") : "one by one",
+		instancedBodies ? bodyRenderer.drawnCircles() : 0, instancedBodies ? bodyRenderer.drawnRects() : 0), GetScreenWidth() - 280, 190, 10, LIGHTGRAY);
+	DrawText(TextFormat("[N] draw batch: %d x %d quads, %s, %d stalls", rlGetRenderBatchBuffers(), rlGetRenderBatchElements(),
+		BatchUploadModeName(rlGetRenderBatchUploadMode()), rlGetRenderBatchStalls()), GetScreenWidth() - 280, 205, 10, LIGHTGRAY);
+	DrawText(TextFormat("[O] draw sorting: %s, %d draw calls", rlIsDrawSortingEnabled() ? "on" : "off", rlGetRenderBatchDrawCalls()), GetScreenWidth() - 280, 220, 10, LIGHTGRAY);
+	DrawText(TextFormat("[1-4] debug lines: %s, %d drawn", debugCategories.empty() ? "none" : debugCategories.c_str(), debugRenderer.drawnLines()), GetScreenWidth() - 280, 175, 10, LIGHTGRAY);
+	DrawText(TextFormat("rewind: %d snapshots, %.1f kB", history.count(), history.bytes() / 1024.0f), GetScreenWidth() - 280, 130, 10, LIGHTGRAY);
+	DrawText(TextFormat("[C] contacts: %s, %d warm started", SolverModeName(world.solverMode), world.solver.warmStarted()), GetScreenWidth() - 280, 70, 10, LIGHTGRAY);
+
 	Vector2 startPos = { startX, startY };
-	Vector2 velocity = { speed * cos(angle * DEG2RAD), -speed * sin(angle * DEG2RAD)};
+	Vector2 velocity = { speed * cosf(angle * DEG2RAD), -speed * sinf(angle * DEG2RAD) };
 
 	DrawLineEx(startPos, startPos + velocity, 3, RED);
 
-	GuiSliderBar(Rectangle{ 100, 110, 400, 20 }, "halfspace X", TextFormat("X: %.0f", halfspace.position.x), &halfspace.position.x, 0, GetScreenWidth());
-	GuiSliderBar(Rectangle{ 700, 110, 400, 20 }, "halfspace Y", TextFormat("Y: %.0f", halfspace.position.y), &halfspace.position.y, 0, GetScreenHeight());
+	Vector2 aimHit;
+	if (world.raycast(startPos, startPos + velocity, &aimHit)) {
+		DrawCircleLines(aimHit.x, aimHit.y, 5, RED);
+	}
+
+	Vector2 halfspacePosition = halfspace.getPosition();
+	Vector2 oldHalfspacePosition = halfspacePosition;
+	GuiSliderBar(Rectangle{ 100, 110, 400, 20 }, "halfspace X", TextFormat("X: %.0f", halfspacePosition.x), &halfspacePosition.x, 0, GetScreenWidth());
+	GuiSliderBar(Rectangle{ 700, 110, 400, 20 }, "halfspace Y", TextFormat("Y: %.0f", halfspacePosition.y), &halfspacePosition.y, 0, GetScreenHeight());
+	halfspace.setPosition(halfspacePosition);
 
 	float halfspaceRotation = halfspace.getRotation();
+	float oldHalfspaceRotation = halfspaceRotation;
 	GuiSliderBar(Rectangle{ 100, 130, 800, 20 }, "rotation", TextFormat("rotation: %.0f", halfspace.getRotation()), &halfspaceRotation, -360, 360);
 	halfspace.setRotationDegrees(halfspaceRotation);
 
+	// nothing sleeping notices the ground or gravity changing under it
+	if (gravityY != world.accelerationGravity.y || halfspaceRotation != oldHalfspaceRotation
+		|| halfspacePosition.x != oldHalfspacePosition.x || halfspacePosition.y != oldHalfspacePosition.y) {
+		world.islands.wakeAll(world.bodies);
+	}
+
 	//control for friction
 	GuiSliderBar(Rectangle{ 700, 150, 400, 20 }, "u", TextFormat("Y: %.2f", coefficientOfFriction), &coefficientOfFriction, 0, 1);
 
@@ -786,10 +327,13 @@ void draw()
 
 
 	for (int i = 0; i < world.objekts.size(); i++) {
-		world.objekts[i]->draw();
+		if (!instancedBodies || world.objekts[i]->Shape() == HALF_SPACE) DrawObjekt(world.objekts[i]);
 	}
+	if (instancedBodies) bodyRenderer.draw(world, world.interpolation(), { 0, 0, (float)GetScreenWidth(), (float)GetScreenHeight() });
 
-	
+	debugRenderer.draw(world.debugDraw, { 0, 0, (float)GetScreenWidth(), (float)GetScreenHeight() });
+
+	if (showProfiler) drawProfiler();
 
 	EndDrawing();
 
@@ -811,11 +355,21 @@ int main()
 
 	InitWindow(InitialWidth, InitialHeight, "Mactavish Carney 101534351 GAME2005");
 	SetTargetFPS(TARGET_FPS);
-	halfspace.isStatic = true;
-	halfspace.position = { 500, 700 };
+	// the batch grows to whatever a frame drew last, thousands of bodies drawn one by one would flush it over and over
+	rlSetRenderBatchAdaptive(true);
+	rlEnableDrawSorting();
+	world.fixedStep = 1.0f / PHYSICS_HZ;
+	history.capacity = (int)(REWIND_SECONDS * PHYSICS_HZ);
+	world.deterministic = true;
+	world.debugDraw.categories = DEBUG_FORCES | DEBUG_CONTACTS;
+	debugRenderer.load();
+	bodyRenderer.load();
+	world.boundsPolicy = BOUNDS_KILL;
+	halfspace.setStatic(true);
+	halfspace.setPosition({ 500, 700 });
 	world.add(&halfspace);
 
-	MakeDeleteableObjekts();
+	MakeDeleteableObjekts(world);
 	bool isBirdCircle = true;
 	while (!WindowShouldClose())
 	{
@@ -836,6 +390,16 @@ int main()
 			}
 		}
 
+		// right drag shoves around whatever was under the mouse last frame
+		if (IsMouseButtonDown(MOUSE_RIGHT_BUTTON)) {
+			Vector2 mouseDelta = GetMouseDelta();
+			FizziksObjekt* picked = world.queryPoint(mouse_position - mouseDelta);
+			if (picked != nullptr && !picked->isStatic()) {
+				picked->setPosition(picked->getPosition() + mouseDelta);
+				picked->setVelocity({ 0, 0 });
+			}
+		}
+
 		if (IsMouseButtonDown(MOUSE_LEFT_BUTTON) && CheckCollisionPointCircle(mouse_position, slingshot_position, slingshot_radius)) {
 			slingshot_state = SLING_DRAG;
 		}
@@ -848,28 +412,29 @@ int main()
 			}
 			else {
 				if (isBirdCircle) {
-					FizziksCircle* newBird = new FizziksCircle();
-					newBird->position = bird_position;
-					newBird->velocity = dispFromBirdToSling * 10;
+					FizziksCircle* newBird = world.createCircle();
+					newBird->setPosition(bird_position);
+					newBird->setVelocity(dispFromBirdToSling * 10);
+					// fast enough to go straight through a wall in one step otherwise
+					newBird->setBullet(true);
 					newBird->bounciness = restitution;
 					newBird->grippiness = coefficientOfFriction;
 					newBird->tag = "bird";
 					newBird->color = BLUE;
 					newBird->baseColor = BLUE;
-					world.add(newBird);
 
 					slingshot_state = SLING_IDLE;
 				}
 				else {
-					FizziksAABB* newBird = new FizziksAABB();
-					newBird->position = bird_position;
-					newBird->velocity = dispFromBirdToSling * 10;
+					FizziksAABB* newBird = world.createAABB();
+					newBird->setPosition(bird_position);
+					newBird->setVelocity(dispFromBirdToSling * 10);
+					newBird->setBullet(true);
 					newBird->bounciness = restitution;
 					newBird->grippiness = coefficientOfFriction;
 					newBird->color = BLUE;
 					newBird->baseColor = BLUE;
 					newBird->sizeXY = { 30, 30 };
-					world.add(newBird);
 
 					slingshot_state = SLING_IDLE;
 				}
@@ -890,6 +455,8 @@ int main()
 		
 	}
 
+	debugRenderer.unload();
+	bodyRenderer.unload();
 	CloseWindow();
 	return 0;
 }
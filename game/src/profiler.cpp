@@ -0,0 +1,117 @@
+#include "profiler.h"
+#include <chrono>
+#include <cstdio>
+
+static const char* stageNames[PROFILE_STAGE_COUNT] = {
+	"update", "resetNetForces", "addGravityForces", "checkCollisions", "broad phase", "narrow phase", "solver",
+	"sleep", "bullets", "applyKinematics", "cleanup", "stateHash"
+};
+
+static const int stageDepths[PROFILE_STAGE_COUNT] = { 0, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1 };
+
+static const char* counterNames[PROFILE_COUNTER_COUNT] = { "pair tests", "contacts", "active bodies" };
+
+const char* FizziksProfileStageName(FizziksProfileStage stage) {
+	return stage >= 0 && stage < PROFILE_STAGE_COUNT ? stageNames[stage] : "?";
+}
+
+int FizziksProfileStageDepth(FizziksProfileStage stage) {
+	return stage >= 0 && stage < PROFILE_STAGE_COUNT ? stageDepths[stage] : 0;
+}
+
+const char* FizziksProfileCounterName(FizziksProfileCounter counter) {
+	return counter >= 0 && counter < PROFILE_COUNTER_COUNT ? counterNames[counter] : "?";
+}
+
+// everything's timed from the first profiler made, so frames from different worlds line up in a trace
+static std::chrono::steady_clock::time_point Origin() {
+	static const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+	return origin;
+}
+
+FizziksProfiler::FizziksProfiler() {
+	Origin();
+	setHistoryLength(240);
+}
+
+void FizziksProfiler::setHistoryLength(int length) {
+	frames.clear();
+	frames.resize(length > 1 ? length : 1);
+	newest = -1;
+	stored = 0;
+	inFrame = false;
+}
+
+double FizziksProfiler::now() const {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - Origin()).count();
+}
+
+void FizziksProfiler::beginFrame() {
+	inFrame = enabled;
+	if (!inFrame) return;
+
+	newest = (newest + 1) % (int)frames.size();
+	FizziksProfileFrame& frame = frames[newest];
+	frame.start = now();
+	for (double& seconds : frame.stageSeconds) seconds = 0;
+	for (int& counter : frame.counters) counter = 0;
+	frame.events.clear();
+}
+
+void FizziksProfiler::endFrame() {
+	if (!inFrame) return;
+	inFrame = false;
+
+	const FizziksProfileFrame& frame = frames[newest];
+	if (stored < (int)frames.size()) stored++;
+	total++;
+	for (int s = 0; s < PROFILE_STAGE_COUNT; s++) totalSeconds[s] += frame.stageSeconds[s];
+	for (int c = 0; c < PROFILE_COUNTER_COUNT; c++) totalCounts[c] += frame.counters[c];
+}
+
+void FizziksProfiler::record(FizziksProfileStage stage, double start, double end) {
+	if (!inFrame) return;
+	FizziksProfileFrame& frame = frames[newest];
+	frame.stageSeconds[stage] += end - start;
+	frame.events.push_back({ stage, start, end - start });
+}
+
+void FizziksProfiler::count(FizziksProfileCounter counter, int value) {
+	if (inFrame) frames[newest].counters[counter] += value;
+}
+
+const FizziksProfileFrame& FizziksProfiler::frame(int ago) const {
+	// the one in progress doesn't count, it isn't finished
+	int latest = inFrame ? newest - 1 : newest;
+	int size = (int)frames.size();
+	return frames[((latest - ago) % size + size) % size];
+}
+
+bool FizziksProfiler::writeChromeTrace(const char* path) const {
+	FILE* file = fopen(path, "w");
+	if (file == nullptr) return false;
+
+	// oldest first, times in microseconds
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"physics\"}}");
+	for (int ago = stored - 1; ago >= 0; ago--) {
+		const FizziksProfileFrame& f = frame(ago);
+		for (const FizziksProfileEvent& event : f.events) {
+			fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"physics\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+				stageNames[event.stage], event.start * 1e6, event.duration * 1e6);
+		}
+		for (int c = 0; c < PROFILE_COUNTER_COUNT; c++) {
+			fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"args\":{\"count\":%d}}",
+				counterNames[c], f.start * 1e6, f.counters[c]);
+		}
+	}
+	fprintf(file, "\n]}\n");
+	return fclose(file) == 0;
+}
+
+void FizziksProfiler::clear() {
+	setHistoryLength((int)frames.size());
+	total = 0;
+	for (double& seconds : totalSeconds) seconds = 0;
+	for (long long& counts : totalCounts) counts = 0;
+}
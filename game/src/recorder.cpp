@@ -0,0 +1,379 @@
+#include "recorder.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+// raylib.lib already has sdefl and sinfl built into it (rcore.c), renamed here so the game
+// can link both copies
+#define sdefl_bound FizziksSdeflBound
+#define sdeflate FizziksSdeflate
+#define zsdeflate FizziksZsdeflate
+#define sinflate FizziksSinflate
+#define zsinflate FizziksZsinflate
+// the vendored code has helpers it never calls, keep -Wall quiet about them
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable : 4505)
+#elif defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#endif
+#define SDEFL_IMPLEMENTATION
+#include "external/sdefl.h"
+#define SINFL_IMPLEMENTATION
+#include "external/sinfl.h"
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#elif defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+static const char TRAJECTORY_MAGIC[4] = { 'F', 'Z', 'T', 'R' };
+static const char TRAJECTORY_END_MAGIC[4] = { 'F', 'Z', 'T', 'E' };
+// a chunk is handed over early once it's this big, sdefl counts in ints
+static const size_t CHUNK_BYTE_LIMIT = 64u << 20;
+
+static size_t FrameBytes(unsigned int bodyCount) {
+	return sizeof(unsigned int) + 4 * sizeof(float) * (size_t)bodyCount;
+}
+
+// finds where each frame starts in a chunk's raw bytes, false if they don't add up to its size
+static bool FindFrames(const unsigned char* data, size_t size, unsigned int frameCount, std::vector<size_t>& offsets) {
+	offsets.clear();
+	size_t offset = 0;
+	for (unsigned int f = 0; f < frameCount; f++) {
+		if (size - offset < sizeof(unsigned int)) return false;
+		unsigned int bodyCount;
+		memcpy(&bodyCount, data + offset, sizeof(bodyCount));
+		if ((size - offset - sizeof(unsigned int)) / (4 * sizeof(float)) < bodyCount) return false;
+		offsets.push_back(offset);
+		offset += FrameBytes(bodyCount);
+	}
+	return offset == size;
+}
+
+// xors every frame with the one before it where the body counts match. back to front so each
+// frame is xor'd with the one before it as it was recorded
+static void XorFrames(unsigned char* data, const std::vector<size_t>& offsets) {
+	for (int f = (int)offsets.size() - 1; f > 0; f--) {
+		unsigned int count, previousCount;
+		memcpy(&count, data + offsets[f], sizeof(count));
+		memcpy(&previousCount, data + offsets[f - 1], sizeof(previousCount));
+		if (count != previousCount) continue;
+
+		unsigned char* words = data + offsets[f] + sizeof(unsigned int);
+		const unsigned char* previous = data + offsets[f - 1] + sizeof(unsigned int);
+		for (size_t i = 0; i < 4 * sizeof(float) * (size_t)count; i++) words[i] ^= previous[i];
+	}
+}
+
+// XorFrames undone, front to back
+static void UnxorFrames(unsigned char* data, const std::vector<size_t>& offsets) {
+	for (int f = 1; f < (int)offsets.size(); f++) {
+		unsigned int count, previousCount;
+		memcpy(&count, data + offsets[f], sizeof(count));
+		memcpy(&previousCount, data + offsets[f - 1], sizeof(previousCount));
+		if (count != previousCount) continue;
+
+		unsigned char* words = data + offsets[f] + sizeof(unsigned int);
+		const unsigned char* previous = data + offsets[f - 1] + sizeof(unsigned int);
+		for (size_t i = 0; i < 4 * sizeof(float) * (size_t)count; i++) words[i] ^= previous[i];
+	}
+}
+
+// splits each of a frame's float arrays into byte planes, every float's lowest byte first, then
+// every float's second byte... after the xor the high planes are nearly all zeros and the low
+// ones noise, which deflate does far better on than the two interleaved
+static void SplitBytes(unsigned char* data, const std::vector<size_t>& offsets, std::vector<unsigned char>& scratch, bool undo) {
+	for (size_t offset : offsets) {
+		unsigned int count;
+		memcpy(&count, data + offset, sizeof(count));
+		unsigned char* array = data + offset + sizeof(unsigned int);
+		scratch.resize(count * sizeof(float));
+		for (int a = 0; a < 4; a++, array += count * sizeof(float)) {
+			memcpy(scratch.data(), array, count * sizeof(float));
+			for (unsigned int i = 0; i < count; i++) {
+				for (int b = 0; b < (int)sizeof(float); b++) {
+					if (undo) array[i * sizeof(float) + b] = scratch[b * count + i];
+					else array[b * count + i] = scratch[i * sizeof(float) + b];
+				}
+			}
+		}
+	}
+}
+
+struct FizziksTrajectoryRecorder::State {
+	FILE* file = nullptr;
+	int level = SDEFL_LVL_DEF;
+	std::thread worker;
+	std::mutex mutex;
+	std::condition_variable changed;
+
+	// record() fills filling, submit() swaps it with pending, the worker swaps pending with working
+	std::vector<unsigned char> filling;
+	unsigned int fillingFirst = 0;
+	unsigned int fillingFrames = 0;
+	std::vector<unsigned char> pending;
+	unsigned int pendingFirst = 0;
+	unsigned int pendingFrames = 0;
+	bool hasPending = false;
+	bool stopping = false;
+
+	// only the worker touches these until it's been joined
+	std::vector<unsigned char> working;
+	std::vector<unsigned char> compressed;
+	std::vector<size_t> frameOffsets;
+	std::vector<unsigned char> scratch;
+	sdefl deflate;
+	std::vector<FizziksTrajectoryIndexEntry> index;
+	bool failed = false;
+
+	std::atomic<unsigned long long> written{ 0 };
+
+	void write(const void* data, size_t bytes) {
+		if (!failed && bytes > 0 && fwrite(data, 1, bytes, file) != bytes) failed = true;
+		written += bytes;
+	}
+
+	void compress(unsigned int firstFrame, unsigned int frameCount) {
+		FindFrames(working.data(), working.size(), frameCount, frameOffsets);
+		XorFrames(working.data(), frameOffsets);
+		SplitBytes(working.data(), frameOffsets, scratch, false);
+
+		compressed.resize(sdefl_bound((int)working.size()));
+		int size = sdeflate(&deflate, compressed.data(), working.data(), (int)working.size(), level);
+
+		FizziksTrajectoryIndexEntry entry = { written, firstFrame, frameCount };
+		index.push_back(entry);
+		FizziksTrajectoryChunk chunk = { firstFrame, frameCount, (unsigned int)working.size(), (unsigned int)size };
+		write(&chunk, sizeof(chunk));
+		write(compressed.data(), size);
+	}
+
+	void run() {
+		std::unique_lock<std::mutex> lock(mutex);
+		for (;;) {
+			changed.wait(lock, [this] { return hasPending || stopping; });
+			if (!hasPending) return;
+
+			working.swap(pending);
+			unsigned int firstFrame = pendingFirst;
+			unsigned int frameCount = pendingFrames;
+			hasPending = false;
+			changed.notify_all();
+
+			lock.unlock();
+			compress(firstFrame, frameCount);
+			lock.lock();
+		}
+	}
+};
+
+bool FizziksTrajectoryRecorder::open(const char* path) {
+	close();
+	FILE* file = fopen(path, "wb");
+	if (file == nullptr) return false;
+
+	state = new State();
+	state->file = file;
+	state->level = std::min(std::max(compressionLevel, SDEFL_LVL_MIN), SDEFL_LVL_MAX);
+	frames = 0;
+	raw = 0;
+
+	FizziksTrajectoryHeader header = {};
+	memcpy(header.magic, TRAJECTORY_MAGIC, sizeof(header.magic));
+	header.version = FIZZIKS_TRAJECTORY_VERSION;
+	header.framesPerChunk = (unsigned int)std::max(framesPerChunk, 1);
+	state->write(&header, sizeof(header));
+
+	state->worker = std::thread(&State::run, state);
+	return true;
+}
+
+void FizziksTrajectoryRecorder::record(const FizziksWorld& world) {
+	if (state == nullptr) return;
+
+	const FizziksBodies& bodies = world.bodies;
+	unsigned int count = (unsigned int)bodies.size();
+	std::vector<unsigned char>& filling = state->filling;
+	size_t offset = filling.size();
+	filling.resize(offset + FrameBytes(count));
+
+	unsigned char* out = filling.data() + offset;
+	memcpy(out, &count, sizeof(count));
+	out += sizeof(count);
+	const std::vector<float>* arrays[] = { &bodies.positionX, &bodies.positionY, &bodies.velocityX, &bodies.velocityY };
+	for (const std::vector<float>* array : arrays) {
+		if (count > 0) memcpy(out, array->data(), count * sizeof(float));
+		out += count * sizeof(float);
+	}
+
+	if (state->fillingFrames == 0) state->fillingFirst = frames;
+	state->fillingFrames++;
+	frames++;
+	raw += FrameBytes(count);
+
+	if (state->fillingFrames >= (unsigned int)std::max(framesPerChunk, 1) || filling.size() >= CHUNK_BYTE_LIMIT) submit();
+}
+
+void FizziksTrajectoryRecorder::submit() {
+	if (state->fillingFrames == 0) return;
+
+	// only waits if the worker still hasn't picked up the chunk before this one
+	std::unique_lock<std::mutex> lock(state->mutex);
+	state->changed.wait(lock, [this] { return !state->hasPending; });
+	state->pending.swap(state->filling);
+	state->pendingFirst = state->fillingFirst;
+	state->pendingFrames = state->fillingFrames;
+	state->hasPending = true;
+	state->changed.notify_all();
+	lock.unlock();
+
+	state->filling.clear();
+	state->fillingFrames = 0;
+}
+
+bool FizziksTrajectoryRecorder::close() {
+	if (state == nullptr) return false;
+
+	submit();
+	{
+		std::lock_guard<std::mutex> lock(state->mutex);
+		state->stopping = true;
+	}
+	state->changed.notify_all();
+	state->worker.join();
+
+	FizziksTrajectoryFooter footer = {};
+	footer.indexOffset = state->written;
+	footer.chunkCount = (unsigned int)state->index.size();
+	footer.frameCount = (unsigned int)frames;
+	memcpy(footer.magic, TRAJECTORY_END_MAGIC, sizeof(footer.magic));
+	state->write(state->index.data(), state->index.size() * sizeof(FizziksTrajectoryIndexEntry));
+	state->write(&footer, sizeof(footer));
+
+	bool ok = !state->failed;
+	ok = fclose(state->file) == 0 && ok;
+	delete state;
+	state = nullptr;
+	return ok;
+}
+
+unsigned long long FizziksTrajectoryRecorder::bytesWritten() const {
+	return state != nullptr ? state->written.load() : 0;
+}
+
+bool FizziksTrajectoryReader::open(const char* path) {
+	close();
+	if (!file.open(path)) return false;
+
+	const unsigned char* data = file.data();
+	size_t size = file.size();
+	FizziksTrajectoryHeader header;
+	if (size < sizeof(header)) return false;
+	memcpy(&header, data, sizeof(header));
+	if (memcmp(header.magic, TRAJECTORY_MAGIC, sizeof(header.magic)) != 0 || header.version != FIZZIKS_TRAJECTORY_VERSION) {
+		close();
+		return false;
+	}
+
+	// the index from the footer if there is one and it makes sense
+	FizziksTrajectoryFooter footer;
+	bool indexed = false;
+	if (size >= sizeof(header) + sizeof(footer)) {
+		memcpy(&footer, data + size - sizeof(footer), sizeof(footer));
+		size_t indexEnd = size - sizeof(footer);
+		indexed = memcmp(footer.magic, TRAJECTORY_END_MAGIC, sizeof(footer.magic)) == 0
+			&& footer.indexOffset >= sizeof(header) && footer.indexOffset <= indexEnd
+			&& (indexEnd - footer.indexOffset) == footer.chunkCount * sizeof(FizziksTrajectoryIndexEntry);
+	}
+	if (indexed) {
+		index.resize(footer.chunkCount);
+		if (footer.chunkCount > 0) memcpy(index.data(), data + footer.indexOffset, footer.chunkCount * sizeof(FizziksTrajectoryIndexEntry));
+	}
+	else {
+		// no footer, so walk the chunks and keep every whole one
+		size_t offset = sizeof(header);
+		unsigned int nextFrame = 0;
+		FizziksTrajectoryChunk chunk;
+		while (size - offset >= sizeof(chunk)) {
+			memcpy(&chunk, data + offset, sizeof(chunk));
+			if (chunk.firstFrame != nextFrame || chunk.frameCount == 0 || size - offset - sizeof(chunk) < chunk.compressedSize) break;
+			FizziksTrajectoryIndexEntry entry = { offset, chunk.firstFrame, chunk.frameCount };
+			index.push_back(entry);
+			nextFrame += chunk.frameCount;
+			offset += sizeof(chunk) + chunk.compressedSize;
+		}
+	}
+
+	// chunks have to follow on from each other for the search in readFrame
+	unsigned int nextFrame = 0;
+	for (const FizziksTrajectoryIndexEntry& entry : index) {
+		if (entry.firstFrame != nextFrame || entry.frameCount == 0 || entry.offset > size) {
+			close();
+			return false;
+		}
+		nextFrame += entry.frameCount;
+	}
+	frames = (int)nextFrame;
+	return true;
+}
+
+void FizziksTrajectoryReader::close() {
+	file.close();
+	index.clear();
+	frames = 0;
+	cachedChunk = -1;
+	chunkData.clear();
+	frameOffsets.clear();
+}
+
+bool FizziksTrajectoryReader::loadChunk(int chunk) {
+	if (chunk == cachedChunk) return true;
+	cachedChunk = -1;
+
+	const FizziksTrajectoryIndexEntry& entry = index[chunk];
+	size_t size = file.size();
+	FizziksTrajectoryChunk header;
+	if (size - entry.offset < sizeof(header)) return false;
+	memcpy(&header, file.data() + entry.offset, sizeof(header));
+	if (header.firstFrame != entry.firstFrame || header.frameCount != entry.frameCount) return false;
+	if (size - entry.offset - sizeof(header) < header.compressedSize || header.rawSize > (unsigned int)INT_MAX) return false;
+
+	chunkData.resize(header.rawSize);
+	int inflated = sinflate(chunkData.data(), (int)header.rawSize, file.data() + entry.offset + sizeof(header), (int)header.compressedSize);
+	if (inflated != (int)header.rawSize) return false;
+	if (!FindFrames(chunkData.data(), chunkData.size(), header.frameCount, frameOffsets)) return false;
+	SplitBytes(chunkData.data(), frameOffsets, scratch, true);
+	UnxorFrames(chunkData.data(), frameOffsets);
+
+	cachedChunk = chunk;
+	return true;
+}
+
+bool FizziksTrajectoryReader::readFrame(int frame, FizziksTrajectoryFrame& out) {
+	if (frame < 0 || frame >= frames) return false;
+
+	// the last chunk starting at or before frame
+	auto found = std::upper_bound(index.begin(), index.end(), (unsigned int)frame,
+		[](unsigned int f, const FizziksTrajectoryIndexEntry& entry) { return f < entry.firstFrame; });
+	int chunk = (int)(found - index.begin()) - 1;
+	if (!loadChunk(chunk)) return false;
+
+	const unsigned char* in = chunkData.data() + frameOffsets[frame - index[chunk].firstFrame];
+	unsigned int count;
+	memcpy(&count, in, sizeof(count));
+	in += sizeof(count);
+	std::vector<float>* arrays[] = { &out.positionX, &out.positionY, &out.velocityX, &out.velocityY };
+	for (std::vector<float>* array : arrays) {
+		array->resize(count);
+		if (count > 0) memcpy(array->data(), in, count * sizeof(float));
+		in += count * sizeof(float);
+	}
+	return true;
+}
@@ -0,0 +1,159 @@
+#include "scenefile.h"
+#include "mappedfile.h"
+#include <cstdio>
+#include <cstring>
+
+static const char SCENE_MAGIC[4] = { 'F', 'Z', 'S', 'C' };
+
+static size_t SectionElementSize(int section) {
+	switch (section) {
+	case SCENE_FLAGS: return sizeof(unsigned char);
+	case SCENE_SHAPES: return sizeof(FizziksSceneShape);
+	default: return sizeof(float);
+	}
+}
+
+static size_t AlignUp(size_t offset) {
+	return (offset + SCENE_ALIGNMENT - 1) / SCENE_ALIGNMENT * SCENE_ALIGNMENT;
+}
+
+bool FizziksSaveScene(const FizziksWorld& world, const char* path) {
+	const FizziksBodies& bodies = world.bodies;
+	int count = (int)world.objekts.size();
+
+	FizziksSceneHeader header = {};
+	memcpy(header.magic, SCENE_MAGIC, sizeof(header.magic));
+	header.version = FIZZIKS_SCENE_VERSION;
+	header.headerSize = sizeof(FizziksSceneHeader);
+	header.objektCount = (unsigned int)count;
+	header.gravityX = world.accelerationGravity.x;
+	header.gravityY = world.accelerationGravity.y;
+
+	size_t offset = AlignUp(sizeof(FizziksSceneHeader));
+	for (int s = 0; s < SCENE_SECTION_COUNT; s++) {
+		header.sections[s] = offset;
+		offset = AlignUp(offset + SectionElementSize(s) * count);
+	}
+
+	std::vector<unsigned char> flags(count);
+	std::vector<FizziksSceneShape> shapes(count);
+	for (int i = 0; i < count; i++) {
+		FizziksObjekt* objekt = world.objekts[i];
+		flags[i] = bodies.flags[i] & (BODY_STATIC | BODY_BULLET);
+
+		FizziksSceneShape& entry = shapes[i];
+		entry = {};
+		entry.shape = (unsigned char)objekt->Shape();
+		entry.color = (unsigned int)objekt->baseColor.r | ((unsigned int)objekt->baseColor.g << 8)
+			| ((unsigned int)objekt->baseColor.b << 16) | ((unsigned int)objekt->baseColor.a << 24);
+		entry.bounciness = objekt->bounciness;
+		entry.grippiness = objekt->grippiness;
+		switch (objekt->Shape()) {
+		case CIRCLE: entry.parameterA = ((FizziksCircle*)objekt)->radius; break;
+		case AABB:
+			entry.parameterA = ((FizziksAABB*)objekt)->sizeXY.x;
+			entry.parameterB = ((FizziksAABB*)objekt)->sizeXY.y;
+			break;
+		case HALF_SPACE: entry.parameterA = ((FizziksHalfspace*)objekt)->getRotation(); break;
+		default: break;
+		}
+	}
+
+	const void* sources[SCENE_SECTION_COUNT] = {
+		bodies.positionX.data(), bodies.positionY.data(), bodies.velocityX.data(), bodies.velocityY.data(),
+		bodies.mass.data(), bodies.inverseMass.data(), flags.data(), shapes.data()
+	};
+
+	FILE* file = fopen(path, "wb");
+	if (file == nullptr) return false;
+
+	static const unsigned char zeros[SCENE_ALIGNMENT] = {};
+	bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+	size_t written = sizeof(header);
+	for (int s = 0; ok && s < SCENE_SECTION_COUNT; s++) {
+		ok = fwrite(zeros, 1, header.sections[s] - written, file) == header.sections[s] - written;
+		size_t bytes = SectionElementSize(s) * count;
+		if (ok && bytes > 0) ok = fwrite(sources[s], 1, bytes, file) == bytes;
+		written = header.sections[s] + bytes;
+	}
+	ok = fclose(file) == 0 && ok;
+	return ok;
+}
+
+bool FizziksLoadScene(FizziksWorld& world, const char* path) {
+	FizziksMappedFile file;
+	if (!file.open(path)) return false;
+
+	// everything is checked up front so a bad file never leaves half a scene behind
+	const unsigned char* data = file.data();
+	if (file.size() < sizeof(FizziksSceneHeader)) return false;
+	FizziksSceneHeader header;
+	memcpy(&header, data, sizeof(header));
+	if (memcmp(header.magic, SCENE_MAGIC, sizeof(header.magic)) != 0 || header.version != FIZZIKS_SCENE_VERSION) return false;
+	if (header.headerSize < sizeof(FizziksSceneHeader)) return false;
+
+	size_t count = header.objektCount;
+	for (int s = 0; s < SCENE_SECTION_COUNT; s++) {
+		unsigned long long offset = header.sections[s];
+		if (offset % SCENE_ALIGNMENT != 0 || offset > file.size()) return false;
+		if ((file.size() - offset) / SectionElementSize(s) < count) return false;
+	}
+
+	const FizziksSceneShape* shapes = (const FizziksSceneShape*)(data + header.sections[SCENE_SHAPES]);
+	const unsigned char* flags = data + header.sections[SCENE_FLAGS];
+	for (size_t i = 0; i < count; i++) {
+		if (shapes[i].shape >= SHAPE_COUNT || (flags[i] & ~(BODY_STATIC | BODY_BULLET)) != 0) return false;
+	}
+
+	FizziksBodies& bodies = world.bodies;
+	int base = bodies.size();
+	bodies.reserve(base + (int)count);
+	world.objekts.reserve(base + count);
+
+	// the objekts have to exist one by one, their bodies are filled in below all at once
+	for (size_t i = 0; i < count; i++) {
+		const FizziksSceneShape& entry = shapes[i];
+		FizziksObjekt* objekt = nullptr;
+		switch ((FizziksShape)entry.shape) {
+		case CIRCLE: {
+			FizziksCircle* circle = world.createCircle();
+			circle->radius = entry.parameterA;
+			objekt = circle;
+			break;
+		}
+		case AABB: {
+			FizziksAABB* aabb = world.createAABB();
+			aabb->sizeXY = { entry.parameterA, entry.parameterB };
+			objekt = aabb;
+			break;
+		}
+		case HALF_SPACE: {
+			FizziksHalfspace* halfspace = world.createHalfspace();
+			halfspace->setRotationDegrees(entry.parameterA);
+			objekt = halfspace;
+			break;
+		}
+		default:
+			continue;
+		}
+
+		objekt->baseColor = { (unsigned char)entry.color, (unsigned char)(entry.color >> 8), (unsigned char)(entry.color >> 16), (unsigned char)(entry.color >> 24) };
+		objekt->color = objekt->baseColor;
+		objekt->bounciness = entry.bounciness;
+		objekt->grippiness = entry.grippiness;
+	}
+
+	size_t floatBytes = count * sizeof(float);
+	memcpy(bodies.positionX.data() + base, data + header.sections[SCENE_POSITION_X], floatBytes);
+	memcpy(bodies.positionY.data() + base, data + header.sections[SCENE_POSITION_Y], floatBytes);
+	memcpy(bodies.previousX.data() + base, data + header.sections[SCENE_POSITION_X], floatBytes);
+	memcpy(bodies.previousY.data() + base, data + header.sections[SCENE_POSITION_Y], floatBytes);
+	memcpy(bodies.velocityX.data() + base, data + header.sections[SCENE_VELOCITY_X], floatBytes);
+	memcpy(bodies.velocityY.data() + base, data + header.sections[SCENE_VELOCITY_Y], floatBytes);
+	memcpy(bodies.mass.data() + base, data + header.sections[SCENE_MASS], floatBytes);
+	memcpy(bodies.inverseMass.data() + base, data + header.sections[SCENE_INVERSE_MASS], floatBytes);
+	memcpy(bodies.flags.data() + base, flags, count);
+
+	world.accelerationGravity = { header.gravityX, header.gravityY };
+	return true;
+}
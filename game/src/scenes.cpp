@@ -0,0 +1,196 @@
+#include "scenes.h"
+#include <cstring>
+
+// same little lcg everywhere so a seed means the same thing on every compiler
+static float SceneRandom(unsigned int& state) {
+	state = state * 1664525u + 1013904223u;
+	return (state >> 8) * (1.0f / 16777216.0f);
+}
+
+static FizziksHalfspace* AddFloor(FizziksWorld& world, float y) {
+	FizziksHalfspace* floor = world.createHalfspace();
+	floor->setStatic(true);
+	floor->setPosition({ 0, y });
+	return floor;
+}
+
+const char* FizziksSceneName(FizziksScene scene) {
+	switch (scene) {
+	case SCENE_SLINGSHOT: return "slingshot";
+	case SCENE_CIRCLE_PILE: return "pile";
+	case SCENE_AABB_TOWER: return "tower";
+	case SCENE_MIXED_RAIN: return "rain";
+	}
+	return "?";
+}
+
+bool FizziksSceneFromName(const char* name, FizziksScene* scene) {
+	for (int i = SCENE_SLINGSHOT; i <= SCENE_MIXED_RAIN; i++) {
+		if (strcmp(name, FizziksSceneName((FizziksScene)i)) == 0) {
+			*scene = (FizziksScene)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+void MakeDeleteableObjekts(FizziksWorld& world) {
+
+	FizziksCircle* c1 = world.createCircle();
+	c1->setPosition({ 550, 635 });
+
+	FizziksCircle* c2 = world.createCircle();
+	c2->setPosition({ 750, 635 });
+
+	FizziksCircle* c3 = world.createCircle();
+	c3->setPosition({ 650, 285 });
+
+	FizziksAABB* aabb = world.createAABB();
+	aabb->setPosition({ 0, 650 });
+	aabb->sizeXY = { 2000, 50 };
+	aabb->setVelocity({ 0, 0 });
+	aabb->color = BLUE;
+	aabb->baseColor = BLUE;
+	aabb->setStatic(true);
+
+	FizziksAABB* aabb1 = world.createAABB();
+	aabb1->setPosition({ 450, 550 });
+	aabb1->sizeXY = { 50, 100 };
+	aabb1->setVelocity({ 0, 0 });
+	aabb1->color = GREEN;
+	aabb1->baseColor = GREEN;
+	aabb1->setMass(1);
+
+	FizziksAABB* aabb2 = world.createAABB();
+	aabb2->setPosition({ 450, 450 });
+	aabb2->sizeXY = { 50, 100 };
+	aabb2->setVelocity({ 0, 0 });
+	aabb2->color = YELLOW;
+	aabb2->baseColor = YELLOW;
+	aabb2->setMass(1);
+
+	FizziksAABB* aabb3 = world.createAABB();
+	aabb3->setPosition({ 450, 350 });
+	aabb3->sizeXY = { 50, 100 };
+	aabb3->setVelocity({ 0, 0 });
+	aabb3->color = ORANGE;
+	aabb3->baseColor = ORANGE;
+	aabb3->setMass(1);
+
+	FizziksAABB* aabb4 = world.createAABB();
+	aabb4->setPosition({ 450, 300 });
+	aabb4->sizeXY = { 400, 50 };
+	aabb4->setVelocity({ 0, 0 });
+	aabb4->color = ORANGE;
+	aabb4->baseColor = ORANGE;
+	aabb4->setMass(1);
+
+	FizziksAABB* aabb5 = world.createAABB();
+	aabb5->setPosition({ 800, 550 });
+	aabb5->sizeXY = { 50, 100 };
+	aabb5->setVelocity({ 0, 0 });
+	aabb5->color = GREEN;
+	aabb5->baseColor = GREEN;
+	aabb5->setMass(1);
+
+	FizziksAABB* aabb6 = world.createAABB();
+	aabb6->setPosition({ 800, 450 });
+	aabb6->sizeXY = { 50, 100 };
+	aabb6->setVelocity({ 0, 0 });
+	aabb6->color = YELLOW;
+	aabb6->baseColor = YELLOW;
+	aabb6->setMass(1);
+
+	FizziksAABB* aabb7 = world.createAABB();
+	aabb7->setPosition({ 800, 350 });
+	aabb7->sizeXY = { 50, 100 };
+	aabb7->setVelocity({ 0, 0 });
+	aabb7->color = ORANGE;
+	aabb7->baseColor = ORANGE;
+	aabb7->setMass(1);
+
+
+}
+
+// circles dropped in a loose grid so they land on each other and settle into a heap
+static void MakeCirclePile(FizziksWorld& world, int count, unsigned int& seed) {
+	const float spacing = 24;
+	int columns = (int)sqrtf((float)count) * 2 + 1;
+	int rows = (count + columns - 1) / columns;
+	float floorY = rows * spacing + 100;
+	AddFloor(world, floorY);
+
+	for (int i = 0; i < count; i++) {
+		FizziksCircle* circle = world.createCircle();
+		circle->radius = 6 + SceneRandom(seed) * 5;
+		circle->setPosition({ (i % columns) * spacing + SceneRandom(seed) * 4, floorY - 50 - (i / columns) * spacing });
+		circle->setMass(1 + SceneRandom(seed));
+	}
+}
+
+// towers of boxes 20 high on a static slab, the worst case for resting contact
+static void MakeAABBTower(FizziksWorld& world, int count, unsigned int& seed) {
+	const int boxesPerTower = 20;
+	const float boxSize = 20;
+	const float gap = 10;
+	int towers = (count + boxesPerTower - 1) / boxesPerTower;
+	float groundY = boxesPerTower * boxSize + 100;
+
+	FizziksAABB* ground = world.createAABB();
+	ground->setPosition({ -100, groundY });
+	ground->sizeXY = { towers * (boxSize + gap) + 200, 50 };
+	ground->color = BLUE;
+	ground->baseColor = BLUE;
+	ground->setStatic(true);
+
+	for (int i = 0; i < count; i++) {
+		int tower = i / boxesPerTower;
+		int level = i % boxesPerTower;
+		FizziksAABB* box = world.createAABB();
+		box->sizeXY = { boxSize, boxSize };
+		box->setPosition({ tower * (boxSize + gap) + SceneRandom(seed) * 2, groundY - (level + 1) * boxSize });
+	}
+}
+
+// circles and boxes falling from random heights with a bit of sideways speed
+static void MakeMixedRain(FizziksWorld& world, int count, unsigned int& seed) {
+	float width = sqrtf((float)count) * 40 + 200;
+	float height = width * 0.5f;
+	AddFloor(world, height + 100);
+
+	for (int i = 0; i < count; i++) {
+		Vector2 position = { SceneRandom(seed) * width, SceneRandom(seed) * height };
+		Vector2 velocity = { (SceneRandom(seed) - 0.5f) * 100, SceneRandom(seed) * 50 };
+
+		if (i % 2 == 0) {
+			FizziksCircle* circle = world.createCircle();
+			circle->radius = 4 + SceneRandom(seed) * 6;
+			circle->setPosition(position);
+			circle->setVelocity(velocity);
+		}
+		else {
+			FizziksAABB* box = world.createAABB();
+			box->sizeXY = { 8 + SceneRandom(seed) * 12, 8 + SceneRandom(seed) * 12 };
+			box->setPosition(position);
+			box->setVelocity(velocity);
+		}
+	}
+}
+
+void MakeScene(FizziksWorld& world, FizziksScene scene, int count, unsigned int seed) {
+	switch (scene) {
+	case SCENE_SLINGSHOT:
+		AddFloor(world, 700);
+		MakeDeleteableObjekts(world);
+		break;
+	case SCENE_CIRCLE_PILE: MakeCirclePile(world, count, seed); break;
+	case SCENE_AABB_TOWER: MakeAABBTower(world, count, seed); break;
+	case SCENE_MIXED_RAIN: MakeMixedRain(world, count, seed); break;
+	}
+}
+
+void DestroyObjekts(FizziksWorld& world) {
+	while (!world.objekts.empty()) {
+		world.destroy((int)world.objekts.size() - 1);
+	}
+}
@@ -0,0 +1,348 @@
+#include "snapshot.h"
+#include <cstring>
+
+// header words, then COLUMN_COUNT columns of one word per objekt
+enum {
+	STATE_OBJEKT_COUNT,
+	STATE_GRAVITY_X,
+	STATE_GRAVITY_Y,
+	STATE_ACCUMULATOR,
+	STATE_HEADER_WORDS
+};
+
+enum {
+	COLUMN_SHAPE,
+	COLUMN_FLAGS,
+	COLUMN_POSITION_X,
+	COLUMN_POSITION_Y,
+	COLUMN_VELOCITY_X,
+	COLUMN_VELOCITY_Y,
+	COLUMN_FORCE_X,
+	COLUMN_FORCE_Y,
+	COLUMN_MASS,
+	COLUMN_SLEEP_TIME,
+	COLUMN_BOUNCINESS,
+	COLUMN_GRIPPINESS,
+	COLUMN_COLOR,
+	COLUMN_BASE_COLOR,
+	COLUMN_PARAMETER_A, // radius, box width or half-space rotation
+	COLUMN_PARAMETER_B, // box height
+	COLUMN_COUNT
+};
+
+const int WARM_START_WORDS = 6; // a, b, normal x and y, normal and tangent impulse
+
+const unsigned char SNAPSHOT_MAGIC[4] = { 'F', 'Z', 'S', 'N' };
+const unsigned char SNAPSHOT_VERSION = 1;
+const unsigned char SNAPSHOT_KEY = 0;
+const unsigned char SNAPSHOT_DELTA = 1;
+
+static unsigned int FloatBits(float value) {
+	unsigned int bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+static float BitsFloat(unsigned int bits) {
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+static unsigned int ColorBits(Color color) {
+	return (unsigned int)color.r | ((unsigned int)color.g << 8) | ((unsigned int)color.b << 16) | ((unsigned int)color.a << 24);
+}
+
+static Color BitsColor(unsigned int bits) {
+	return { (unsigned char)bits, (unsigned char)(bits >> 8), (unsigned char)(bits >> 16), (unsigned char)(bits >> 24) };
+}
+
+void FizziksCaptureState(const FizziksWorld& world, FizziksWorldState& state) {
+	const FizziksBodies& bodies = world.bodies;
+	int count = (int)world.objekts.size();
+
+	state.assign(STATE_HEADER_WORDS + COLUMN_COUNT * count, 0);
+	state[STATE_OBJEKT_COUNT] = (unsigned int)count;
+	state[STATE_GRAVITY_X] = FloatBits(world.accelerationGravity.x);
+	state[STATE_GRAVITY_Y] = FloatBits(world.accelerationGravity.y);
+	state[STATE_ACCUMULATOR] = FloatBits(world.accumulator);
+
+	unsigned int* column[COLUMN_COUNT];
+	for (int c = 0; c < COLUMN_COUNT; c++) column[c] = state.data() + STATE_HEADER_WORDS + c * count;
+
+	for (int i = 0; i < count; i++) {
+		FizziksObjekt* objekt = world.objekts[i];
+		column[COLUMN_SHAPE][i] = objekt->Shape();
+		column[COLUMN_FLAGS][i] = bodies.flags[i] & ~BODY_DEAD;
+		column[COLUMN_POSITION_X][i] = FloatBits(bodies.positionX[i]);
+		column[COLUMN_POSITION_Y][i] = FloatBits(bodies.positionY[i]);
+		column[COLUMN_VELOCITY_X][i] = FloatBits(bodies.velocityX[i]);
+		column[COLUMN_VELOCITY_Y][i] = FloatBits(bodies.velocityY[i]);
+		column[COLUMN_FORCE_X][i] = FloatBits(bodies.forceX[i]);
+		column[COLUMN_FORCE_Y][i] = FloatBits(bodies.forceY[i]);
+		column[COLUMN_MASS][i] = FloatBits(bodies.mass[i]);
+		column[COLUMN_SLEEP_TIME][i] = FloatBits(bodies.sleepTime[i]);
+		column[COLUMN_BOUNCINESS][i] = FloatBits(objekt->bounciness);
+		column[COLUMN_GRIPPINESS][i] = FloatBits(objekt->grippiness);
+		column[COLUMN_COLOR][i] = ColorBits(objekt->color);
+		column[COLUMN_BASE_COLOR][i] = ColorBits(objekt->baseColor);
+
+		switch (objekt->Shape()) {
+		case CIRCLE:
+			column[COLUMN_PARAMETER_A][i] = FloatBits(((FizziksCircle*)objekt)->radius);
+			break;
+		case AABB:
+			column[COLUMN_PARAMETER_A][i] = FloatBits(((FizziksAABB*)objekt)->sizeXY.x);
+			column[COLUMN_PARAMETER_B][i] = FloatBits(((FizziksAABB*)objekt)->sizeXY.y);
+			break;
+		case HALF_SPACE:
+			column[COLUMN_PARAMETER_A][i] = FloatBits(((FizziksHalfspace*)objekt)->getRotation());
+			break;
+		default:
+			break;
+		}
+	}
+
+	std::vector<FizziksContact> warmStart;
+	world.solver.saveWarmStart(bodies, warmStart);
+	state.push_back((unsigned int)warmStart.size());
+	for (const FizziksContact& contact : warmStart) {
+		state.push_back((unsigned int)contact.a);
+		state.push_back((unsigned int)contact.b);
+		state.push_back(FloatBits(contact.normal.x));
+		state.push_back(FloatBits(contact.normal.y));
+		state.push_back(FloatBits(contact.normalImpulse));
+		state.push_back(FloatBits(contact.tangentImpulse));
+	}
+
+	std::vector<int> sleepingPairs;
+	world.islands.saveSleepingPairs(bodies, sleepingPairs);
+	state.push_back((unsigned int)sleepingPairs.size());
+	for (int index : sleepingPairs) state.push_back((unsigned int)index);
+}
+
+bool FizziksRestoreState(FizziksWorld& world, const FizziksWorldState& state) {
+	// check it all hangs together before touching the world
+	if (state.size() < STATE_HEADER_WORDS) return false;
+	size_t count = state[STATE_OBJEKT_COUNT];
+	if ((state.size() - STATE_HEADER_WORDS) / COLUMN_COUNT < count) return false;
+
+	size_t warmStartAt = STATE_HEADER_WORDS + COLUMN_COUNT * count;
+	if (warmStartAt >= state.size()) return false;
+	size_t warmStartCount = state[warmStartAt];
+	if ((state.size() - warmStartAt - 1) / WARM_START_WORDS < warmStartCount) return false;
+
+	size_t sleepingAt = warmStartAt + 1 + WARM_START_WORDS * warmStartCount;
+	if (sleepingAt >= state.size() || state.size() - sleepingAt - 1 != state[sleepingAt]) return false;
+
+	const unsigned int* column[COLUMN_COUNT];
+	for (int c = 0; c < COLUMN_COUNT; c++) column[c] = state.data() + STATE_HEADER_WORDS + c * count;
+	for (size_t i = 0; i < count; i++) {
+		if (column[COLUMN_SHAPE][i] >= SHAPE_COUNT) return false;
+	}
+
+	world.flushDestroyed();
+
+	// keep every objekt up to the first one that's the wrong shape, make the rest again
+	int kept = 0;
+	while (kept < count && kept < world.objekts.size() && world.objekts[kept]->Shape() == (FizziksShape)column[COLUMN_SHAPE][kept]) kept++;
+	while (world.objekts.size() > kept) world.destroy((int)world.objekts.size() - 1);
+	for (int i = kept; i < count; i++) {
+		switch ((FizziksShape)column[COLUMN_SHAPE][i]) {
+		case CIRCLE: world.createCircle(); break;
+		case AABB: world.createAABB(); break;
+		case HALF_SPACE: world.createHalfspace(); break;
+		default: break;
+		}
+	}
+
+	FizziksBodies& bodies = world.bodies;
+	for (int i = 0; i < count; i++) {
+		FizziksObjekt* objekt = world.objekts[i];
+		bodies.positionX[i] = BitsFloat(column[COLUMN_POSITION_X][i]);
+		bodies.positionY[i] = BitsFloat(column[COLUMN_POSITION_Y][i]);
+		bodies.previousX[i] = bodies.positionX[i];
+		bodies.previousY[i] = bodies.positionY[i];
+		bodies.velocityX[i] = BitsFloat(column[COLUMN_VELOCITY_X][i]);
+		bodies.velocityY[i] = BitsFloat(column[COLUMN_VELOCITY_Y][i]);
+		bodies.forceX[i] = BitsFloat(column[COLUMN_FORCE_X][i]);
+		bodies.forceY[i] = BitsFloat(column[COLUMN_FORCE_Y][i]);
+		bodies.flags[i] = (unsigned char)column[COLUMN_FLAGS][i];
+		bodies.setMass(i, BitsFloat(column[COLUMN_MASS][i])); // after the flags, static bodies get no inverse mass
+		bodies.sleepTime[i] = BitsFloat(column[COLUMN_SLEEP_TIME][i]);
+
+		objekt->bounciness = BitsFloat(column[COLUMN_BOUNCINESS][i]);
+		objekt->grippiness = BitsFloat(column[COLUMN_GRIPPINESS][i]);
+		objekt->color = BitsColor(column[COLUMN_COLOR][i]);
+		objekt->baseColor = BitsColor(column[COLUMN_BASE_COLOR][i]);
+
+		switch (objekt->Shape()) {
+		case CIRCLE:
+			((FizziksCircle*)objekt)->radius = BitsFloat(column[COLUMN_PARAMETER_A][i]);
+			break;
+		case AABB:
+			((FizziksAABB*)objekt)->sizeXY = { BitsFloat(column[COLUMN_PARAMETER_A][i]), BitsFloat(column[COLUMN_PARAMETER_B][i]) };
+			break;
+		case HALF_SPACE:
+			((FizziksHalfspace*)objekt)->setRotationDegrees(BitsFloat(column[COLUMN_PARAMETER_A][i]));
+			break;
+		default:
+			break;
+		}
+	}
+
+	world.accelerationGravity = { BitsFloat(state[STATE_GRAVITY_X]), BitsFloat(state[STATE_GRAVITY_Y]) };
+	world.accumulator = BitsFloat(state[STATE_ACCUMULATOR]);
+
+	std::vector<FizziksContact> warmStart(warmStartCount);
+	for (size_t w = 0; w < warmStartCount; w++) {
+		const unsigned int* words = state.data() + warmStartAt + 1 + w * WARM_START_WORDS;
+		warmStart[w].a = (int)words[0];
+		warmStart[w].b = (int)words[1];
+		warmStart[w].normal = { BitsFloat(words[2]), BitsFloat(words[3]) };
+		warmStart[w].normalImpulse = BitsFloat(words[4]);
+		warmStart[w].tangentImpulse = BitsFloat(words[5]);
+	}
+	world.solver.loadWarmStart(warmStart, bodies);
+
+	std::vector<int> sleepingPairs(state.begin() + sleepingAt + 1, state.end());
+	world.islands.loadSleepingPairs(sleepingPairs, bodies);
+	return true;
+}
+
+static void PutVarint(std::vector<unsigned char>& blob, unsigned long long value) {
+	while (value >= 0x80) {
+		blob.push_back((unsigned char)(value | 0x80));
+		value >>= 7;
+	}
+	blob.push_back((unsigned char)value);
+}
+
+static bool GetVarint(const unsigned char*& at, const unsigned char* end, unsigned long long* value) {
+	*value = 0;
+	for (int shift = 0; shift < 64; shift += 7) {
+		if (at >= end) return false;
+		unsigned char byte = *at++;
+		*value |= (unsigned long long)(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0) return true;
+	}
+	return false;
+}
+
+void FizziksEncodeSnapshot(const FizziksWorldState& state, const FizziksWorldState* base, std::vector<unsigned char>& blob) {
+	blob.assign(SNAPSHOT_MAGIC, SNAPSHOT_MAGIC + 4);
+	blob.push_back(SNAPSHOT_VERSION);
+	blob.push_back(base ? SNAPSHOT_DELTA : SNAPSHOT_KEY);
+	PutVarint(blob, state.size());
+
+	// a word is its value shifted up one, a run of zeros is the run length shifted up one with the low bit set
+	size_t baseSize = base ? base->size() : 0;
+	unsigned long long zeros = 0;
+	for (size_t w = 0; w < state.size(); w++) {
+		unsigned int word = w < baseSize ? state[w] ^ (*base)[w] : state[w];
+		if (word == 0) {
+			zeros++;
+			continue;
+		}
+		if (zeros > 0) PutVarint(blob, (zeros << 1) | 1);
+		zeros = 0;
+		PutVarint(blob, (unsigned long long)word << 1);
+	}
+	if (zeros > 0) PutVarint(blob, (zeros << 1) | 1);
+}
+
+bool FizziksDecodeSnapshot(const unsigned char* blob, int size, const FizziksWorldState* base, FizziksWorldState& state) {
+	if (size < 6 || memcmp(blob, SNAPSHOT_MAGIC, 4) != 0 || blob[4] != SNAPSHOT_VERSION) return false;
+	bool delta = blob[5] == SNAPSHOT_DELTA;
+	if (!delta && blob[5] != SNAPSHOT_KEY) return false;
+	if (delta && base == nullptr) return false;
+
+	const unsigned char* at = blob + 6;
+	const unsigned char* end = blob + size;
+	unsigned long long wordCount;
+	if (!GetVarint(at, end, &wordCount) || wordCount > (unsigned long long)size * 64) return false; // even all zeros can't pack tighter than that
+
+	state.resize((size_t)wordCount);
+	size_t w = 0;
+	while (w < wordCount) {
+		unsigned long long token;
+		if (!GetVarint(at, end, &token)) return false;
+
+		if (token & 1) {
+			unsigned long long zeros = token >> 1;
+			if (zeros > wordCount - w) return false;
+			for (; zeros > 0; zeros--, w++) state[w] = 0;
+		}
+		else {
+			if ((token >> 1) > 0xFFFFFFFFull) return false;
+			state[w++] = (unsigned int)(token >> 1);
+		}
+	}
+	if (at != end) return false;
+
+	if (delta) {
+		size_t shared = std::min(state.size(), base->size());
+		for (size_t i = 0; i < shared; i++) state[i] ^= (*base)[i];
+	}
+	return true;
+}
+
+int FizziksSnapshotHistory::record(const FizziksWorld& world) {
+	// the oldest interval starts with a key and nothing before it needs it, so it can go whole
+	int interval = keyInterval > 1 ? keyInterval : 1;
+	int dropped = 0;
+	if (capacity > 0 && count() >= capacity && count() > interval) {
+		dropped = interval;
+		dropOldest(dropped);
+	}
+
+	FizziksCaptureState(world, current);
+
+	bool key = keyInterval <= 1 || count() % keyInterval == 0;
+	FizziksEncodeSnapshot(current, key ? nullptr : &last, blob);
+	offsets.push_back(data.size());
+	data.insert(data.end(), blob.begin(), blob.end());
+	last.swap(current);
+	return dropped;
+}
+
+bool FizziksSnapshotHistory::decode(int index, FizziksWorldState& state, FizziksWorldState& scratch) const {
+	int interval = keyInterval > 1 ? keyInterval : 1;
+	int first = index - index % interval;
+	for (int i = first; i <= index; i++) {
+		size_t begin = offsets[i];
+		size_t end = i + 1 < count() ? offsets[i + 1] : data.size();
+		if (!FizziksDecodeSnapshot(data.data() + begin, (int)(end - begin), i > first ? &state : nullptr, scratch)) return false;
+		state.swap(scratch);
+	}
+	return true;
+}
+
+bool FizziksSnapshotHistory::restore(FizziksWorld& world, int index) {
+	if (index < 0 || index >= count()) return false;
+	if (!decode(index, current, scratch)) return false;
+	if (!FizziksRestoreState(world, current)) return false;
+
+	truncate(index + 1);
+	last.swap(current);
+	return true;
+}
+
+void FizziksSnapshotHistory::truncate(int newCount) {
+	if (newCount >= count()) return;
+	data.resize(offsets[newCount]);
+	offsets.resize(newCount);
+}
+
+void FizziksSnapshotHistory::dropOldest(int dropCount) {
+	size_t begin = offsets[dropCount];
+	data.erase(data.begin(), data.begin() + begin);
+	offsets.erase(offsets.begin(), offsets.begin() + dropCount);
+	for (size_t& offset : offsets) offset -= begin;
+}
+
+void FizziksSnapshotHistory::clear() {
+	data.clear();
+	offsets.clear();
+	last.clear();
+}
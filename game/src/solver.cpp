@@ -0,0 +1,158 @@
+#include "solver.h"
+#include "islands.h"
+#include "raymath.h"
+#include <algorithm>
+
+static unsigned long long PairKey(FizziksBodyHandle a, FizziksBodyHandle b) {
+	return ((unsigned long long)a.slot << 32) | b.slot;
+}
+
+static bool SameBody(FizziksBodyHandle l, FizziksBodyHandle r) {
+	return l.slot == r.slot && l.generation == r.generation;
+}
+
+// static bodies are shared between islands, so nothing writes to them even though
+// an inverse mass of 0 would leave them as they were
+static inline void ApplyImpulse(FizziksBodies& bodies, int a, int b, Vector2 impulse, float inverseMassA, float inverseMassB) {
+	if (inverseMassA > 0) {
+		bodies.velocityX[a] -= impulse.x * inverseMassA;
+		bodies.velocityY[a] -= impulse.y * inverseMassA;
+	}
+	if (inverseMassB > 0) {
+		bodies.velocityX[b] += impulse.x * inverseMassB;
+		bodies.velocityY[b] += impulse.y * inverseMassB;
+	}
+}
+
+// only reads the bodies, so every contact can be prepared at once
+void FizziksContactSolver::prepare(FizziksContact& contact, Row& row, const FizziksBodies& bodies, float inverseDt) {
+	int a = contact.a;
+	int b = contact.b;
+
+	row.inverseMassA = bodies.inverseMass[a];
+	row.inverseMassB = bodies.inverseMass[b];
+	float inverseMassSum = row.inverseMassA + row.inverseMassB;
+	row.mass = inverseMassSum > 0 ? 1.0f / inverseMassSum : 0;
+
+	// bounce off whatever closing speed there was before the solver touched it, otherwise
+	// just push out the overlap beyond the slop over a few steps
+	Vector2 relativeVelocity = { bodies.velocityX[b] - bodies.velocityX[a], bodies.velocityY[b] - bodies.velocityY[a] };
+	float closing = Vector2DotProduct(relativeVelocity, contact.normal);
+	row.bias = baumgarte * inverseDt * fmaxf(contact.depth - slop, 0.0f);
+	if (-closing > restitutionThreshold) row.bias = fmaxf(row.bias, -contact.restitution * closing);
+
+	contact.normalImpulse = 0;
+	contact.tangentImpulse = 0;
+	row.warmStarted = false;
+	if (!warmStarting) return;
+
+	FizziksBodyHandle bodyA = bodies.handleAt(a);
+	FizziksBodyHandle bodyB = bodies.handleAt(b);
+	unsigned long long key = PairKey(bodyA, bodyB);
+	auto found = std::lower_bound(cache.begin(), cache.end(), key, [](const CachedImpulse& cached, unsigned long long k) { return cached.key < k; });
+	// a normal that flipped round (an aabb pair changing axis) means last step's impulse points the wrong way
+	if (found != cache.end() && found->key == key && SameBody(found->bodyA, bodyA) && SameBody(found->bodyB, bodyB)
+		&& Vector2DotProduct(found->normal, contact.normal) > 0.9f) {
+		contact.normalImpulse = found->normalImpulse;
+		contact.tangentImpulse = found->tangentImpulse;
+		row.warmStarted = true;
+	}
+}
+
+void FizziksContactSolver::solveIsland(std::vector<FizziksContact>& contacts, const int* order, int count, FizziksBodies& bodies) {
+	const float* velocityX = bodies.velocityX.data();
+	const float* velocityY = bodies.velocityY.data();
+
+	// applied here rather than in prepare() so every bias saw the velocities from before any of this
+	for (int k = 0; k < count; k++) {
+		const FizziksContact& contact = contacts[order[k]];
+		const Row& row = rows[order[k]];
+		if (!row.warmStarted) continue;
+
+		Vector2 tangent = { -contact.normal.y, contact.normal.x };
+		Vector2 impulse = contact.normal * contact.normalImpulse + tangent * contact.tangentImpulse;
+		ApplyImpulse(bodies, contact.a, contact.b, impulse, row.inverseMassA, row.inverseMassB);
+	}
+
+	for (int iteration = 0; iteration < iterations; iteration++) {
+		for (int k = 0; k < count; k++) {
+			FizziksContact& contact = contacts[order[k]];
+			const Row& row = rows[order[k]];
+			if (row.mass == 0) continue;
+
+			int a = contact.a;
+			int b = contact.b;
+			Vector2 normal = contact.normal;
+			Vector2 tangent = { -normal.y, normal.x };
+
+			// friction first so the normal row gets the last word on penetration
+			Vector2 relativeVelocity = { velocityX[b] - velocityX[a], velocityY[b] - velocityY[a] };
+			float maxFriction = contact.friction * contact.normalImpulse;
+			float oldTangentImpulse = contact.tangentImpulse;
+			contact.tangentImpulse = Clamp(oldTangentImpulse - row.mass * Vector2DotProduct(relativeVelocity, tangent), -maxFriction, maxFriction);
+			ApplyImpulse(bodies, a, b, tangent * (contact.tangentImpulse - oldTangentImpulse), row.inverseMassA, row.inverseMassB);
+
+			relativeVelocity = { velocityX[b] - velocityX[a], velocityY[b] - velocityY[a] };
+			float oldNormalImpulse = contact.normalImpulse;
+			contact.normalImpulse = fmaxf(oldNormalImpulse + row.mass * (row.bias - Vector2DotProduct(relativeVelocity, normal)), 0.0f);
+			ApplyImpulse(bodies, a, b, normal * (contact.normalImpulse - oldNormalImpulse), row.inverseMassA, row.inverseMassB);
+		}
+	}
+}
+
+void FizziksContactSolver::solve(std::vector<FizziksContact>& contacts, const FizziksIslands& islands, FizziksBodies& bodies, float dt, FizziksThreadPool& threads) {
+	int count = (int)contacts.size();
+	rows.resize(count);
+	float inverseDt = dt > 0 ? 1.0f / dt : 0;
+
+	threads.parallelFor(count, 256, [&](int begin, int end, int worker) {
+		for (int c = begin; c < end; c++) prepare(contacts[c], rows[c], bodies, inverseDt);
+	});
+
+	threads.run((int)islands.solveOrder.size(), [&](int task, int worker) {
+		int island = islands.solveOrder[task];
+		int begin = islands.contactBegin[island];
+		solveIsland(contacts, islands.contactOrder.data() + begin, islands.contactBegin[island + 1] - begin, bodies);
+	});
+
+	warmStartCount = 0;
+	nextCache.resize(count);
+	for (int c = 0; c < count; c++) {
+		const FizziksContact& contact = contacts[c];
+		FizziksBodyHandle bodyA = bodies.handleAt(contact.a);
+		FizziksBodyHandle bodyB = bodies.handleAt(contact.b);
+		nextCache[c] = { PairKey(bodyA, bodyB), bodyA, bodyB, contact.normal, contact.normalImpulse, contact.tangentImpulse };
+		if (rows[c].warmStarted) warmStartCount++;
+	}
+	std::sort(nextCache.begin(), nextCache.end(), [](const CachedImpulse& l, const CachedImpulse& r) { return l.key < r.key; });
+	cache.swap(nextCache);
+}
+
+void FizziksContactSolver::saveWarmStart(const FizziksBodies& bodies, std::vector<FizziksContact>& saved) const {
+	saved.clear();
+	for (const CachedImpulse& cached : cache) {
+		int a = bodies.indexOf(cached.bodyA);
+		int b = bodies.indexOf(cached.bodyB);
+		if (a < 0 || b < 0) continue;
+
+		FizziksContact contact;
+		contact.a = a;
+		contact.b = b;
+		contact.normal = cached.normal;
+		contact.normalImpulse = cached.normalImpulse;
+		contact.tangentImpulse = cached.tangentImpulse;
+		saved.push_back(contact);
+	}
+}
+
+void FizziksContactSolver::loadWarmStart(const std::vector<FizziksContact>& saved, const FizziksBodies& bodies) {
+	cache.clear();
+	for (const FizziksContact& contact : saved) {
+		if (contact.a < 0 || contact.a >= bodies.size() || contact.b < 0 || contact.b >= bodies.size()) continue;
+
+		FizziksBodyHandle bodyA = bodies.handleAt(contact.a);
+		FizziksBodyHandle bodyB = bodies.handleAt(contact.b);
+		cache.push_back({ PairKey(bodyA, bodyB), bodyA, bodyB, contact.normal, contact.normalImpulse, contact.tangentImpulse });
+	}
+	std::sort(cache.begin(), cache.end(), [](const CachedImpulse& l, const CachedImpulse& r) { return l.key < r.key; });
+}
@@ -0,0 +1,152 @@
+#include "threadpool.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// one worker's tasks. the owner takes from head, thieves from tail, so they only
+// fight over the lock when it's down to its last couple of tasks
+struct TaskQueue {
+	std::mutex lock;
+	std::vector<int> tasks;
+	int head = 0;
+	int tail = 0;
+
+	bool popFront(int* task) {
+		std::lock_guard<std::mutex> guard(lock);
+		if (head == tail) return false;
+		*task = tasks[head++];
+		return true;
+	}
+
+	bool popBack(int* task) {
+		std::lock_guard<std::mutex> guard(lock);
+		if (head == tail) return false;
+		*task = tasks[--tail];
+		return true;
+	}
+};
+
+struct FizziksThreadPool::State {
+	std::vector<std::thread> workers;
+	std::unique_ptr<TaskQueue[]> queues; // one per worker, the caller's included
+	int queueCount = 0;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable finished;
+
+	const std::function<void(int, int)>* job = nullptr;
+	std::atomic<int> stolen{ 0 };
+	int busy = 0; // workers still on the current job
+	unsigned int generation = 0; // bumped for every job so sleeping workers know there's a new one
+	bool quitting = false;
+
+	void runTasks(int worker) {
+		int task;
+		while (queues[worker].popFront(&task)) (*job)(task, worker);
+
+		// nothing new gets queued while a job runs, so once every queue
+		// has come up empty there's nothing left to steal
+		for (int offset = 1; offset < queueCount; offset++) {
+			TaskQueue& victim = queues[(worker + offset) % queueCount];
+			while (victim.popBack(&task)) {
+				stolen++;
+				(*job)(task, worker);
+			}
+		}
+	}
+
+	void workerLoop(int worker) {
+		unsigned int seen = 0;
+		while (true) {
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				wake.wait(lock, [&] { return quitting || generation != seen; });
+				if (quitting) return;
+				seen = generation;
+			}
+
+			runTasks(worker);
+
+			std::lock_guard<std::mutex> lock(mutex);
+			if (--busy == 0) finished.notify_one();
+		}
+	}
+
+	~State() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			quitting = true;
+		}
+		wake.notify_all();
+		for (std::thread& thread : workers) thread.join();
+	}
+};
+
+FizziksThreadPool::~FizziksThreadPool() {
+	delete state;
+}
+
+void FizziksThreadPool::setThreadCount(int count) {
+	if (count <= 0) count = (int)std::thread::hardware_concurrency();
+	if (count < 1) count = 1;
+	if (count == threads) return;
+
+	delete state;
+	state = nullptr;
+	threads = count;
+	if (count == 1) return;
+
+	state = new State();
+	state->queues.reset(new TaskQueue[count]);
+	state->queueCount = count;
+	for (int worker = 1; worker < count; worker++) {
+		state->workers.emplace_back(&State::workerLoop, state, worker);
+	}
+}
+
+void FizziksThreadPool::run(int count, const std::function<void(int task, int worker)>& job) {
+	stolenCount = 0;
+	if (count <= 0) return;
+
+	// not worth waking anyone for a single task
+	if (state == nullptr || count == 1) {
+		for (int task = 0; task < count; task++) job(task, 0);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(state->mutex);
+		for (int q = 0; q < state->queueCount; q++) {
+			TaskQueue& queue = state->queues[q];
+			queue.tasks.clear();
+			for (int task = q; task < count; task += state->queueCount) queue.tasks.push_back(task);
+			queue.head = 0;
+			queue.tail = (int)queue.tasks.size();
+		}
+		state->job = &job;
+		state->stolen = 0;
+		state->busy = (int)state->workers.size();
+		state->generation++;
+	}
+	state->wake.notify_all();
+
+	state->runTasks(0);
+
+	std::unique_lock<std::mutex> lock(state->mutex);
+	state->finished.wait(lock, [this] { return state->busy == 0; });
+	state->job = nullptr;
+	stolenCount = state->stolen;
+}
+
+void FizziksThreadPool::parallelFor(int count, int grain, const std::function<void(int begin, int end, int worker)>& job) {
+	if (count <= 0) return;
+	if (grain < 1) grain = 1;
+
+	run((count + grain - 1) / grain, [&](int chunk, int worker) {
+		int begin = chunk * grain;
+		job(begin, begin + grain < count ? begin + grain : count, worker);
+	});
+}
@@ -0,0 +1,306 @@
+/*
+Steps a FizziksWorld for a fixed number of frames without a window or gl context,
+then prints how long it took and a checksum of where everything ended up.
+Same scene, count, seed, dt and frames always gives the same checksum on the same build.
+
+usage: physics-headless [options]
+	--scene NAME        slingshot, pile, tower or rain (default pile)
+	--count N           roughly how many objekts (default 1000)
+	--seed N            scene seed (default 1)
+	--frames N          frames to step (default 500)
+	--dt SECONDS        fixed step (default 0.02)
+	--substeps N        passes per step (default 1)
+	--broadphase NAME   brute, grid, sap or tree (default grid)
+	--simd NAME         scalar, sse2 or avx2 (default best available)
+	--threads N         threads for the narrow phase and solver, 0 for one per core (default 1)
+	--solver NAME       impulse or immediate (default impulse)
+	--iterations N      sequential impulse iterations (default 8)
+	--sleep on|off      let still islands sleep (default on)
+	--load FILE         start from a .fzscene file instead of --scene
+	--export FILE       write the world as a .fzscene file after the last frame
+	--checkpoint N      snapshot before frame N, replay the rest from it after the run and
+	                    check both runs end up in the same place
+	--hashes FILE       deterministic mode, writing every frame's state hash to FILE, one per line
+	--record FILE       write every frame's positions and velocities to a .fztraj file, then
+	                    read the last frame back and check it matches
+	--trace FILE        print how long each stage of a step took on average and write the
+	                    last 240 steps as chrome://tracing json to FILE
+	--dump FILE         write the final state of every objekt to FILE
+*/
+
+#include "fizziks.h"
+#include "scenes.h"
+#include "snapshot.h"
+#include "scenefile.h"
+#include "recorder.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static double Seconds() {
+	using namespace std::chrono;
+	return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+static unsigned long long Checksum(const FizziksWorld& world) {
+	unsigned long long sum = 1469598103934665603ull;
+	const std::vector<float>* arrays[] = { &world.bodies.positionX, &world.bodies.positionY, &world.bodies.velocityX, &world.bodies.velocityY };
+	for (const std::vector<float>* array : arrays) {
+		for (float v : *array) {
+			unsigned int bits;
+			memcpy(&bits, &v, sizeof(bits));
+			sum = (sum ^ bits) * 1099511628211ull;
+		}
+	}
+	return sum;
+}
+
+static bool Dump(const FizziksWorld& world, const char* path) {
+	FILE* file = fopen(path, "w");
+	if (file == nullptr) return false;
+
+	const char* shapeNames[] = { "circle", "halfspace", "aabb" };
+	fprintf(file, "# index shape x y vx vy\n");
+	for (int i = 0; i < world.objekts.size(); i++) {
+		FizziksObjekt* objekt = world.objekts[i];
+		Vector2 position = objekt->getPosition();
+		Vector2 velocity = objekt->getVelocity();
+		fprintf(file, "%d %s %.9g %.9g %.9g %.9g\n", i, shapeNames[objekt->Shape()], position.x, position.y, velocity.x, velocity.y);
+	}
+	fclose(file);
+	return true;
+}
+
+static bool BroadphaseFromName(const char* name, FizziksBroadphaseMode* mode) {
+	const char* names[] = { "brute", "grid", "sap", "tree" };
+	for (int i = BROADPHASE_BRUTE_FORCE; i <= BROADPHASE_AABB_TREE; i++) {
+		if (strcmp(name, names[i]) == 0) {
+			*mode = (FizziksBroadphaseMode)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool SolverFromName(const char* name, FizziksSolverMode* mode) {
+	if (strcmp(name, "impulse") == 0) *mode = SOLVER_SEQUENTIAL_IMPULSE;
+	else if (strcmp(name, "immediate") == 0) *mode = SOLVER_IMMEDIATE;
+	else return false;
+	return true;
+}
+
+static bool OnOffFromName(const char* name, bool* on) {
+	if (strcmp(name, "on") == 0) *on = true;
+	else if (strcmp(name, "off") == 0) *on = false;
+	else return false;
+	return true;
+}
+
+static bool SimdFromName(const char* name, FizziksSimdLevel* level) {
+	for (int i = SIMD_SCALAR; i <= SIMD_AVX2; i++) {
+		if (strcmp(name, FizziksSimdLevelName((FizziksSimdLevel)i)) == 0) {
+			*level = (FizziksSimdLevel)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+int main(int argc, char** argv)
+{
+	FizziksScene scene = SCENE_CIRCLE_PILE;
+	int count = 1000;
+	unsigned int seed = 1;
+	int frames = 500;
+	float dt = 1.0f / 50;
+	const char* dumpPath = nullptr;
+	const char* hashesPath = nullptr;
+	const char* loadPath = nullptr;
+	const char* exportPath = nullptr;
+	const char* recordPath = nullptr;
+	const char* tracePath = nullptr;
+	int checkpoint = -1;
+
+	FizziksWorld world;
+
+	for (int i = 1; i < argc; i++) {
+		const char* arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+		bool ok = value != nullptr;
+
+		if (ok && strcmp(arg, "--scene") == 0) ok = FizziksSceneFromName(value, &scene);
+		else if (ok && strcmp(arg, "--count") == 0) count = atoi(value);
+		else if (ok && strcmp(arg, "--seed") == 0) seed = (unsigned int)strtoul(value, nullptr, 10);
+		else if (ok && strcmp(arg, "--frames") == 0) frames = atoi(value);
+		else if (ok && strcmp(arg, "--dt") == 0) dt = (float)atof(value);
+		else if (ok && strcmp(arg, "--substeps") == 0) world.substeps = atoi(value);
+		else if (ok && strcmp(arg, "--broadphase") == 0) ok = BroadphaseFromName(value, &world.broadphaseMode);
+		else if (ok && strcmp(arg, "--simd") == 0) ok = SimdFromName(value, &world.simdLevel);
+		else if (ok && strcmp(arg, "--threads") == 0) world.threads.setThreadCount(atoi(value));
+		else if (ok && strcmp(arg, "--solver") == 0) ok = SolverFromName(value, &world.solverMode);
+		else if (ok && strcmp(arg, "--iterations") == 0) world.solver.iterations = atoi(value);
+		else if (ok && strcmp(arg, "--sleep") == 0) ok = OnOffFromName(value, &world.islands.allowSleep);
+		else if (ok && strcmp(arg, "--checkpoint") == 0) checkpoint = atoi(value);
+		else if (ok && strcmp(arg, "--hashes") == 0) hashesPath = value;
+		else if (ok && strcmp(arg, "--load") == 0) loadPath = value;
+		else if (ok && strcmp(arg, "--export") == 0) exportPath = value;
+		else if (ok && strcmp(arg, "--record") == 0) recordPath = value;
+		else if (ok && strcmp(arg, "--trace") == 0) tracePath = value;
+		else if (ok && strcmp(arg, "--dump") == 0) dumpPath = value;
+		else ok = false;
+
+		if (!ok) {
+			fprintf(stderr, "bad argument '%s'%s%s, see the top of headless/src/main.cpp\n", arg, value ? " " : "", value ? value : "");
+			return 1;
+		}
+		i++;
+	}
+
+	if (world.simdLevel > FizziksBestSimdLevel()) world.simdLevel = FizziksBestSimdLevel();
+
+	FILE* hashes = nullptr;
+	if (hashesPath != nullptr) {
+		hashes = fopen(hashesPath, "w");
+		if (hashes == nullptr) {
+			fprintf(stderr, "couldn't write %s\n", hashesPath);
+			return 1;
+		}
+		world.deterministic = true;
+	}
+
+	FizziksTrajectoryRecorder recorder;
+	if (recordPath != nullptr && !recorder.open(recordPath)) {
+		fprintf(stderr, "couldn't write %s\n", recordPath);
+		return 1;
+	}
+
+	double buildStart = Seconds();
+	if (loadPath != nullptr) {
+		if (!FizziksLoadScene(world, loadPath)) {
+			fprintf(stderr, "couldn't load %s\n", loadPath);
+			return 1;
+		}
+	}
+	else {
+		MakeScene(world, scene, count, seed);
+	}
+	double buildTime = Seconds() - buildStart;
+
+	printf("scene %s, %d objekts (%s in %.2f ms), seed %u, %d frames at dt %g x %d substeps, %s broad phase, %s solver, %s, %d threads\n",
+		loadPath ? loadPath : FizziksSceneName(scene), (int)world.objekts.size(), loadPath ? "loaded" : "built", buildTime * 1000, seed, frames, dt, world.substeps,
+		BroadphaseModeName(world.broadphaseMode), SolverModeName(world.solverMode), FizziksSimdLevelName(world.simdLevel), world.threads.threadCount());
+
+	double total = 0;
+	double slowest = 0;
+	double fastest = 1e30;
+	long long pairs = 0;
+	double recordTime = 0;
+	FizziksWorldState saved;
+
+	for (int frame = 0; frame < frames; frame++) {
+		if (frame == checkpoint) FizziksCaptureState(world, saved);
+
+		double start = Seconds();
+		world.update(dt);
+		double elapsed = Seconds() - start;
+
+		total += elapsed;
+		if (elapsed > slowest) slowest = elapsed;
+		if (elapsed < fastest) fastest = elapsed;
+		pairs += world.candidatePairs;
+		if (hashes != nullptr) fprintf(hashes, "%d %08x\n", frame, world.frameHash);
+
+		if (recorder.isOpen()) {
+			start = Seconds();
+			recorder.record(world);
+			recordTime += Seconds() - start;
+		}
+	}
+	if (hashes != nullptr) fclose(hashes);
+
+	if (frames > 0) {
+		printf("total %.3f s, per frame avg %.3f ms, min %.3f ms, max %.3f ms, %.0f pairs/frame\n",
+			total, total * 1000 / frames, fastest * 1000, slowest * 1000, (double)pairs / frames);
+	}
+	printf("%d of %d bodies asleep in %d islands\n", world.islands.sleepingCount(), world.bodies.size(), world.islands.islandCount());
+	unsigned long long checksum = Checksum(world);
+	printf("checksum %016llx\n", checksum);
+	if (world.deterministic) printf("state hash %08x\n", world.frameHash);
+
+	int result = 0;
+	if (tracePath != nullptr) {
+		const FizziksProfiler& profiler = world.profiler;
+		printf("stages, ms per step:");
+		for (int s = 0; s < PROFILE_STAGE_COUNT; s++) {
+			FizziksProfileStage stage = (FizziksProfileStage)s;
+			printf("%s %s %.3f", s == 0 ? "" : ",", FizziksProfileStageName(stage), profiler.averageSeconds(stage) * 1000);
+		}
+		printf("\nper step:");
+		for (int c = 0; c < PROFILE_COUNTER_COUNT; c++) {
+			printf("%s %s %.0f", c == 0 ? "" : ",", FizziksProfileCounterName((FizziksProfileCounter)c), profiler.averageCount((FizziksProfileCounter)c));
+		}
+		printf("\n");
+		if (!profiler.writeChromeTrace(tracePath)) {
+			fprintf(stderr, "couldn't write %s\n", tracePath);
+			result = 1;
+		}
+	}
+
+	if (recorder.isOpen()) {
+		unsigned long long rawBytes = recorder.rawBytes();
+		double start = Seconds();
+		bool ok = recorder.close();
+		double closeTime = Seconds() - start;
+		unsigned long long fileBytes = 0;
+
+		// the last frame read back has to be exactly the world as it is now
+		FizziksTrajectoryReader reader;
+		FizziksTrajectoryFrame last;
+		bool same = ok && reader.open(recordPath) && reader.frameCount() == frames;
+		if (same && frames > 0) {
+			const FizziksBodies& bodies = world.bodies;
+			size_t bytes = bodies.size() * sizeof(float);
+			same = reader.readFrame(frames - 1, last) && (int)last.positionX.size() == bodies.size()
+				&& memcmp(last.positionX.data(), bodies.positionX.data(), bytes) == 0 && memcmp(last.positionY.data(), bodies.positionY.data(), bytes) == 0
+				&& memcmp(last.velocityX.data(), bodies.velocityX.data(), bytes) == 0 && memcmp(last.velocityY.data(), bodies.velocityY.data(), bytes) == 0;
+		}
+		if (FILE* file = fopen(recordPath, "rb")) {
+			fseek(file, 0, SEEK_END);
+			fileBytes = (unsigned long long)ftell(file);
+			fclose(file);
+		}
+
+		printf("recorded %d frames in %d chunks, %.1f MB raw to %.1f MB (%.1fx), %.3f ms/frame on the step's thread, %.1f ms to close: %s\n",
+			frames, reader.chunkCount(), rawBytes / 1048576.0, fileBytes / 1048576.0, fileBytes > 0 ? (double)rawBytes / fileBytes : 0.0,
+			frames > 0 ? recordTime * 1000 / frames : 0.0, closeTime * 1000, same ? "last frame reads back the same" : "DIFFERENT");
+		if (!same) result = 1;
+	}
+
+	if (checkpoint >= 0 && checkpoint < frames) {
+		std::vector<unsigned char> blob;
+		FizziksEncodeSnapshot(saved, nullptr, blob);
+
+		double start = Seconds();
+		bool restored = FizziksRestoreState(world, saved);
+		double restoreTime = Seconds() - start;
+		for (int frame = checkpoint; restored && frame < frames; frame++) world.update(dt);
+
+		bool same = restored && Checksum(world) == checksum;
+		printf("replayed from frame %d (%d byte snapshot, restored in %.1f us): %s\n", checkpoint, (int)blob.size(), restoreTime * 1e6, same ? "same" : "DIFFERENT");
+		if (!same) result = 1;
+	}
+
+	if (exportPath != nullptr && !FizziksSaveScene(world, exportPath)) {
+		fprintf(stderr, "couldn't write %s\n", exportPath);
+		result = 1;
+	}
+
+	if (dumpPath != nullptr && !Dump(world, dumpPath)) {
+		fprintf(stderr, "couldn't write %s\n", dumpPath);
+		result = 1;
+	}
+
+	DestroyObjekts(world);
+	return result;
+}
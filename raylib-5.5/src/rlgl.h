@@ -52,6 +52,9 @@
 *       #define RL_DEFAULT_BATCH_BUFFER_ELEMENTS   8192    // Default internal render batch elements limits
 *       #define RL_DEFAULT_BATCH_BUFFERS              1    // Default number of batch buffers (multi-buffering)
 *       #define RL_DEFAULT_BATCH_DRAWCALLS          256    // Default number of batch draw calls (by state changes: mode, texture)
+*       #define RL_MAX_SORTED_DRAWCALLS              64    // Maximum number of draw calls reordered together with draw sorting
+*       #define RL_MAX_BATCH_BUFFER_ELEMENTS      65536    // Maximum render batch elements per buffer (adaptive sizing limit)
+*       #define RL_DEFAULT_BATCH_UPLOAD_MODE          0    // Default render batch upload mode (rlBatchUploadMode: SUBDATA, ORPHAN, PERSISTENT)
 *       #define RL_DEFAULT_BATCH_MAX_TEXTURE_UNITS    4    // Maximum number of textures units that can be activated on batch drawing (SetShaderValueTexture())
 *
 *       #define RL_MAX_MATRIX_STACK_SIZE             32    // Maximum size of internal Matrix stack
@@ -218,6 +221,19 @@
 #ifndef RL_DEFAULT_BATCH_DRAWCALLS
     #define RL_DEFAULT_BATCH_DRAWCALLS             256      // Default number of batch draw calls (by state changes: mode, texture)
 #endif
+#ifndef RL_MAX_SORTED_DRAWCALLS
+    #define RL_MAX_SORTED_DRAWCALLS                 64      // Maximum number of draw calls reordered together with draw sorting
+#endif
+#ifndef RL_DEFAULT_BATCH_UPLOAD_MODE
+    #define RL_DEFAULT_BATCH_UPLOAD_MODE  RL_BATCH_UPLOAD_SUBDATA // Default render batch vertex data upload mode (rlBatchUploadMode)
+#endif
+#ifndef RL_MAX_BATCH_BUFFER_ELEMENTS
+    #if defined(GRAPHICS_API_OPENGL_ES2)
+        #define RL_MAX_BATCH_BUFFER_ELEMENTS     16384      // Maximum render batch elements per buffer (unsigned short indices)
+    #else
+        #define RL_MAX_BATCH_BUFFER_ELEMENTS     65536      // Maximum render batch elements per buffer (adaptive sizing limit)
+    #endif
+#endif
 #ifndef RL_DEFAULT_BATCH_MAX_TEXTURE_UNITS
     #define RL_DEFAULT_BATCH_MAX_TEXTURE_UNITS       4      // Maximum number of textures units that can be activated on batch drawing (SetShaderValueTexture())
 #endif
@@ -393,6 +409,7 @@ typedef struct rlVertexBuffer {
 #endif
     unsigned int vaoId;         // OpenGL Vertex Array Object id
     unsigned int vboId[5];      // OpenGL Vertex Buffer Objects id (5 types of vertex data)
+    void *fence;                // OpenGL sync object placed after the last draw from this buffer (persistent mapping only)
 } rlVertexBuffer;
 
 // Draw call type
@@ -406,6 +423,9 @@ typedef struct rlDrawCall {
     //unsigned int vaoId;       // Vertex array id to be used on the draw -> Using RLGL.currentBatch->vertexBuffer.vaoId
     //unsigned int shaderId;    // Shader id to be used on the draw -> Using RLGL.currentShaderId
     unsigned int textureId;     // Texture id to be used on the draw -> Use to create new draw call if changes
+    int layer;                  // Draw layer, lower layers are drawn first (draw sorting only)
+    float minx, miny;           // Vertex bounds minimum (draw sorting only)
+    float maxx, maxy;           // Vertex bounds maximum (draw sorting only)
 
     //Matrix projection;        // Projection matrix for this draw -> Using RLGL.projection by default
     //Matrix modelview;         // Modelview matrix for this draw -> Using RLGL.modelview by default
@@ -415,6 +435,7 @@ typedef struct rlDrawCall {
 typedef struct rlRenderBatch {
     int bufferCount;            // Number of vertex buffers (multi-buffering support)
     int currentBuffer;          // Current buffer tracking in case of multi-buffering
+    int uploadMode;             // Vertex data upload mode (rlBatchUploadMode)
     rlVertexBuffer *vertexBuffer; // Dynamic buffer(s) for vertex data
 
     rlDrawCall *draws;          // Draw calls array, depends on textureId
@@ -589,6 +610,14 @@ typedef enum {
     RL_CULL_FACE_BACK
 } rlCullMode;
 
+// Render batch vertex data upload mode
+// NOTE: Requested modes fall back to what the OpenGL context supports (PERSISTENT -> ORPHAN)
+typedef enum {
+    RL_BATCH_UPLOAD_SUBDATA = 0,    // glBufferSubData() into the buffer in use, may wait for the GPU to finish reading it
+    RL_BATCH_UPLOAD_ORPHAN,         // glBufferData(NULL) orphans the buffer storage first, then glBufferSubData()
+    RL_BATCH_UPLOAD_PERSISTENT      // Vertex data written straight into persistent mapped buffers, fenced per buffer (GL_ARB_buffer_storage)
+} rlBatchUploadMode;
+
 //------------------------------------------------------------------------------------
 // Functions Declaration - Matrix operations
 //------------------------------------------------------------------------------------
@@ -725,6 +754,18 @@ RLAPI void rlDrawRenderBatch(rlRenderBatch *batch);     // Draw render batch dat
 RLAPI void rlSetRenderBatchActive(rlRenderBatch *batch); // Set the active render batch for rlgl (NULL for default internal)
 RLAPI void rlDrawRenderBatchActive(void);               // Update and draw internal render batch
 RLAPI bool rlCheckRenderBatchLimit(int vCount);         // Check internal buffer overflow for a given number of vertex
+RLAPI void rlSetRenderBatchConfig(int numBuffers, int bufferElements, int uploadMode); // Reload default render batch with a ring of numBuffers buffers
+RLAPI void rlSetRenderBatchAdaptive(bool enabled);      // Resize default render batch elements to the vertex count of previous frames
+RLAPI void rlRenderBatchFrameEnd(void);                 // Mark the end of a frame for render batch statistics (called by EndDrawing())
+RLAPI int rlGetRenderBatchBuffers(void);                // Get default render batch number of buffers
+RLAPI int rlGetRenderBatchElements(void);               // Get default render batch elements per buffer
+RLAPI int rlGetRenderBatchUploadMode(void);             // Get default render batch upload mode (rlBatchUploadMode)
+RLAPI int rlGetRenderBatchStalls(void);                 // Get number of waits on a buffer still in use by the GPU during last frame
+RLAPI int rlGetRenderBatchDrawCalls(void);              // Get number of draw calls submitted by render batches during last frame
+RLAPI void rlEnableDrawSorting(void);                   // Enable draw sorting, batch draws that don't overlap are grouped by texture (2D only)
+RLAPI void rlDisableDrawSorting(void);                  // Disable draw sorting, batch draws are submitted in order
+RLAPI bool rlIsDrawSortingEnabled(void);                // Check if draw sorting is enabled
+RLAPI void rlSetDrawLayer(int layer);                   // Set layer for following draws, lower layers are drawn first (draw sorting only)
 
 RLAPI void rlSetTexture(unsigned int id);               // Set current texture for render batch and check buffers limits
 
@@ -1082,6 +1123,21 @@ typedef struct rlglData {
         int framebufferWidth;               // Current framebuffer width
         int framebufferHeight;              // Current framebuffer height
 
+        // Render batch configuration and frame statistics
+        int batchUploadMode;                // Requested upload mode for render batches loaded (rlBatchUploadMode)
+        bool batchAdaptive;                 // Resize default batch to the vertex count of previous frames
+        int batchFrameVertices;             // Vertex drawn by default batch during current frame
+        int batchFramePeak;                 // Maximum vertex drawn by default batch in a single flush during current frame
+        int batchFrameOverflows;            // Default batch flushes forced by a full buffer during current frame
+        int batchFrameStalls;               // Waits on a buffer still in use by the GPU during current frame
+        int batchLastStalls;                // Waits on a buffer still in use by the GPU during last frame
+        int batchShrinkFrames;              // Consecutive frames the default batch could have been smaller
+        int batchFrameDrawCalls;            // Draw calls submitted by render batches during current frame
+        int batchLastDrawCalls;             // Draw calls submitted by render batches during last frame
+
+        bool drawSorting;                   // Draw sorting enabled, draws reordered by texture and mode on batch drawing
+        int drawLayer;                      // Current draw layer (draw sorting only)
+
     } State;            // Renderer state
     struct {
         bool vao;                           // VAO support (OpenGL ES2 could not support VAO extension) (GL_ARB_vertex_array_object)
@@ -1100,6 +1156,7 @@ typedef struct rlglData {
         bool texAnisoFilter;                // Anisotropic texture filtering support (GL_EXT_texture_filter_anisotropic)
         bool computeShader;                 // Compute shaders support (GL_ARB_compute_shader)
         bool ssbo;                          // Shader storage buffer object support (GL_ARB_shader_storage_buffer_object)
+        bool bufferStorage;                 // Immutable buffer storage and persistent mapping support (GL_ARB_buffer_storage)
 
         float maxAnisotropyLevel;           // Maximum anisotropy level supported (minimum is 2.0f)
         int maxDepthBits;                   // Maximum bits for depth component
@@ -1139,6 +1196,14 @@ static PFNGLVERTEXATTRIBDIVISOREXTPROC glVertexAttribDivisor = NULL;
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
 static void rlLoadShaderDefault(void);      // Load default shader
 static void rlUnloadShaderDefault(void);    // Unload default shader
+static void *rlLoadBatchBuffer(unsigned int *id, int size, void *data, int uploadMode); // Load a render batch vertex buffer, returns the memory to write vertex data to
+static void rlLoadBatchVertexArrays(rlVertexBuffer *buffer, int bufferElements); // Load render batch vertex data arrays in RAM
+static bool rlLoadBatchVertexBuffers(rlVertexBuffer *buffer, int bufferElements, int uploadMode); // Load render batch vertex buffers and attributes, false if mapping failed
+static void rlUnloadBatchVertexBuffers(rlVertexBuffer *buffer); // Unmap and delete render batch vertex buffers (not indices)
+static void rlUpdateBatchBuffer(unsigned int id, int bufferSize, int dataSize, const void *data, int uploadMode); // Update a render batch vertex buffer
+static void rlWaitBatchBuffer(rlVertexBuffer *buffer);  // Wait for the GPU to finish reading a persistent mapped render batch buffer
+static void rlReloadRenderBatchDefault(int numBuffers, int bufferElements); // Reload default render batch with a new size
+static void rlDrawRenderBatchSorted(rlRenderBatch *batch);  // Draw render batch draw calls grouped by texture and mode
 #if defined(RLGL_SHOW_GL_DETAILS_INFO)
 static const char *rlGetCompressedFormatName(int format); // Get compressed format official GL identifier name
 #endif  // RLGL_SHOW_GL_DETAILS_INFO
@@ -1528,6 +1593,26 @@ void rlVertex3f(float x, float y, float z)
         }
     }
 
+    // Track draw vertex bounds, draw sorting only moves draws past the ones they don't overlap
+    if (RLGL.State.drawSorting)
+    {
+        rlDrawCall *draw = &RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1];
+
+        if (draw->vertexCount == 0)
+        {
+            draw->layer = RLGL.State.drawLayer;
+            draw->minx = tx; draw->maxx = tx;
+            draw->miny = ty; draw->maxy = ty;
+        }
+        else
+        {
+            if (tx < draw->minx) draw->minx = tx;
+            else if (tx > draw->maxx) draw->maxx = tx;
+            if (ty < draw->miny) draw->miny = ty;
+            else if (ty > draw->maxy) draw->maxy = ty;
+        }
+    }
+
     // Add vertices
     RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].vertices[3*RLGL.State.vertexCounter] = tx;
     RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].vertices[3*RLGL.State.vertexCounter + 1] = ty;
@@ -1637,6 +1722,7 @@ void rlSetTexture(unsigned int id)
         if (RLGL.State.vertexCounter >=
             RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].elementCount*4)
         {
+            if (RLGL.currentBatch == &RLGL.defaultBatch) RLGL.State.batchFrameOverflows++;
             rlDrawRenderBatch(RLGL.currentBatch);
         }
 #endif
@@ -2268,6 +2354,7 @@ void rlglInit(int width, int height)
     // Init default vertex arrays buffers
     // Simulate that the default shader has the location RL_SHADER_LOC_VERTEX_NORMAL to bind the normal buffer for the default render batch
     RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_NORMAL] = RL_DEFAULT_SHADER_ATTRIB_LOCATION_NORMAL;
+    RLGL.State.batchUploadMode = RL_DEFAULT_BATCH_UPLOAD_MODE;
     RLGL.defaultBatch = rlLoadRenderBatch(RL_DEFAULT_BATCH_BUFFERS, RL_DEFAULT_BATCH_BUFFER_ELEMENTS);
     RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_NORMAL] = -1;
     RLGL.currentBatch = &RLGL.defaultBatch;
@@ -2391,6 +2478,7 @@ void rlLoadExtensions(void *loader)
     #if defined(GRAPHICS_API_OPENGL_43)
     RLGL.ExtSupported.computeShader = GLAD_GL_ARB_compute_shader;
     RLGL.ExtSupported.ssbo = GLAD_GL_ARB_shader_storage_buffer_object;
+    RLGL.ExtSupported.bufferStorage = GLAD_GL_ARB_buffer_storage;
     #endif
 
 #endif  // GRAPHICS_API_OPENGL_33
@@ -2623,6 +2711,7 @@ void rlLoadExtensions(void *loader)
     if (RLGL.ExtSupported.texCompASTC) TRACELOG(RL_LOG_INFO, "GL: ASTC compressed textures supported");
     if (RLGL.ExtSupported.computeShader) TRACELOG(RL_LOG_INFO, "GL: Compute shaders supported");
     if (RLGL.ExtSupported.ssbo) TRACELOG(RL_LOG_INFO, "GL: Shader storage buffer objects supported");
+    if (RLGL.ExtSupported.bufferStorage) TRACELOG(RL_LOG_INFO, "GL: Persistent mapped buffers supported");
 #endif  // RLGL_SHOW_GL_DETAILS_INFO
 
 #endif  // GRAPHICS_API_OPENGL_33 || GRAPHICS_API_OPENGL_ES2
@@ -2726,18 +2815,20 @@ rlRenderBatch rlLoadRenderBatch(int numBuffers, int bufferElements)
     rlRenderBatch batch = { 0 };
 
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    // Select vertex data upload mode, persistent mapping requires GL_ARB_buffer_storage
+    batch.uploadMode = RLGL.State.batchUploadMode;
+    if ((batch.uploadMode == RL_BATCH_UPLOAD_PERSISTENT) && !RLGL.ExtSupported.bufferStorage) batch.uploadMode = RL_BATCH_UPLOAD_ORPHAN;
+
     // Initialize CPU (RAM) vertex buffers (position, texcoord, color data and indexes)
+    // NOTE: Persistent mapped buffers get their vertex data arrays mapped from GPU memory once loaded
     //--------------------------------------------------------------------------------------------
-    batch.vertexBuffer = (rlVertexBuffer *)RL_MALLOC(numBuffers*sizeof(rlVertexBuffer));
+    batch.vertexBuffer = (rlVertexBuffer *)RL_CALLOC(numBuffers, sizeof(rlVertexBuffer));
 
     for (int i = 0; i < numBuffers; i++)
     {
         batch.vertexBuffer[i].elementCount = bufferElements;
 
-        batch.vertexBuffer[i].vertices = (float *)RL_MALLOC(bufferElements*3*4*sizeof(float));        // 3 float by vertex, 4 vertex by quad
-        batch.vertexBuffer[i].texcoords = (float *)RL_MALLOC(bufferElements*2*4*sizeof(float));       // 2 float by texcoord, 4 texcoord by quad
-        batch.vertexBuffer[i].normals = (float *)RL_MALLOC(bufferElements*3*4*sizeof(float));        // 3 float by vertex, 4 vertex by quad
-        batch.vertexBuffer[i].colors = (unsigned char *)RL_MALLOC(bufferElements*4*4*sizeof(unsigned char));   // 4 float by color, 4 colors by quad
+        if (batch.uploadMode != RL_BATCH_UPLOAD_PERSISTENT) rlLoadBatchVertexArrays(&batch.vertexBuffer[i], bufferElements);
 #if defined(GRAPHICS_API_OPENGL_33)
         batch.vertexBuffer[i].indices = (unsigned int *)RL_MALLOC(bufferElements*6*sizeof(unsigned int));      // 6 int by quad (indices)
 #endif
@@ -2745,11 +2836,6 @@ rlRenderBatch rlLoadRenderBatch(int numBuffers, int bufferElements)
         batch.vertexBuffer[i].indices = (unsigned short *)RL_MALLOC(bufferElements*6*sizeof(unsigned short));  // 6 int by quad (indices)
 #endif
 
-        for (int j = 0; j < (3*4*bufferElements); j++) batch.vertexBuffer[i].vertices[j] = 0.0f;
-        for (int j = 0; j < (2*4*bufferElements); j++) batch.vertexBuffer[i].texcoords[j] = 0.0f;
-        for (int j = 0; j < (3*4*bufferElements); j++) batch.vertexBuffer[i].normals[j] = 0.0f;
-        for (int j = 0; j < (4*4*bufferElements); j++) batch.vertexBuffer[i].colors[j] = 0;
-
         int k = 0;
 
         // Indices can be initialized right now
@@ -2773,6 +2859,8 @@ rlRenderBatch rlLoadRenderBatch(int numBuffers, int bufferElements)
 
     // Upload to GPU (VRAM) vertex data and initialize VAOs/VBOs
     //--------------------------------------------------------------------------------------------
+    bool mappingFailed = false;
+
     for (int i = 0; i < numBuffers; i++)
     {
         if (RLGL.ExtSupported.vao)
@@ -2783,33 +2871,7 @@ rlRenderBatch rlLoadRenderBatch(int numBuffers, int bufferElements)
         }
 
         // Quads - Vertex buffers binding and attributes enable
-        // Vertex position buffer (shader-location = 0)
-        glGenBuffers(1, &batch.vertexBuffer[i].vboId[0]);
-        glBindBuffer(GL_ARRAY_BUFFER, batch.vertexBuffer[i].vboId[0]);
-        glBufferData(GL_ARRAY_BUFFER, bufferElements*3*4*sizeof(float), batch.vertexBuffer[i].vertices, GL_DYNAMIC_DRAW);
-        glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_POSITION]);
-        glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_POSITION], 3, GL_FLOAT, 0, 0, 0);
-
-        // Vertex texcoord buffer (shader-location = 1)
-        glGenBuffers(1, &batch.vertexBuffer[i].vboId[1]);
-        glBindBuffer(GL_ARRAY_BUFFER, batch.vertexBuffer[i].vboId[1]);
-        glBufferData(GL_ARRAY_BUFFER, bufferElements*2*4*sizeof(float), batch.vertexBuffer[i].texcoords, GL_DYNAMIC_DRAW);
-        glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_TEXCOORD01]);
-        glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_TEXCOORD01], 2, GL_FLOAT, 0, 0, 0);
-
-        // Vertex normal buffer (shader-location = 2)
-        glGenBuffers(1, &batch.vertexBuffer[i].vboId[2]);
-        glBindBuffer(GL_ARRAY_BUFFER, batch.vertexBuffer[i].vboId[2]);
-        glBufferData(GL_ARRAY_BUFFER, bufferElements*3*4*sizeof(float), batch.vertexBuffer[i].normals, GL_DYNAMIC_DRAW);
-        glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_NORMAL]);
-        glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_NORMAL], 3, GL_FLOAT, 0, 0, 0);
-
-        // Vertex color buffer (shader-location = 3)
-        glGenBuffers(1, &batch.vertexBuffer[i].vboId[3]);
-        glBindBuffer(GL_ARRAY_BUFFER, batch.vertexBuffer[i].vboId[3]);
-        glBufferData(GL_ARRAY_BUFFER, bufferElements*4*4*sizeof(unsigned char), batch.vertexBuffer[i].colors, GL_DYNAMIC_DRAW);
-        glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_COLOR]);
-        glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_COLOR], 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, 0);
+        if (!rlLoadBatchVertexBuffers(&batch.vertexBuffer[i], bufferElements, batch.uploadMode)) mappingFailed = true;
 
         // Fill index buffer
         glGenBuffers(1, &batch.vertexBuffer[i].vboId[4]);
@@ -2822,7 +2884,24 @@ rlRenderBatch rlLoadRenderBatch(int numBuffers, int bufferElements)
 #endif
     }
 
+    // Persistent mapping failed, fall back to orphaning with vertex data arrays in RAM before the batch is used
+    if (mappingFailed)
+    {
+        TRACELOG(RL_LOG_WARNING, "RLGL: Failed to map render batch vertex buffers, using buffer orphaning");
+        batch.uploadMode = RL_BATCH_UPLOAD_ORPHAN;
+
+        for (int i = 0; i < numBuffers; i++)
+        {
+            if (RLGL.ExtSupported.vao) glBindVertexArray(batch.vertexBuffer[i].vaoId);
+
+            rlUnloadBatchVertexBuffers(&batch.vertexBuffer[i]);
+            rlLoadBatchVertexArrays(&batch.vertexBuffer[i], bufferElements);
+            rlLoadBatchVertexBuffers(&batch.vertexBuffer[i], bufferElements, batch.uploadMode);
+        }
+    }
+
     TRACELOG(RL_LOG_INFO, "RLGL: Render batch vertex buffers loaded successfully in VRAM (GPU)");
+    if (batch.uploadMode == RL_BATCH_UPLOAD_PERSISTENT) TRACELOG(RL_LOG_INFO, "RLGL: Render batch vertex buffers mapped persistently (%i buffers)", numBuffers);
 
     // Unbind the current VAO
     if (RLGL.ExtSupported.vao) glBindVertexArray(0);
@@ -2875,7 +2954,13 @@ void rlUnloadRenderBatch(rlRenderBatch batch)
             glBindVertexArray(0);
         }
 
+#if defined(GRAPHICS_API_OPENGL_43)
+        // Delete buffer fence, the buffer is released by the driver once the GPU is done with it
+        if (batch.vertexBuffer[i].fence != NULL) glDeleteSync((GLsync)batch.vertexBuffer[i].fence);
+#endif
+
         // Delete VBOs from GPU (VRAM)
+        // NOTE: Persistent mapped buffers are unmapped on deletion
         glDeleteBuffers(1, &batch.vertexBuffer[i].vboId[0]);
         glDeleteBuffers(1, &batch.vertexBuffer[i].vboId[1]);
         glDeleteBuffers(1, &batch.vertexBuffer[i].vboId[2]);
@@ -2886,10 +2971,13 @@ void rlUnloadRenderBatch(rlRenderBatch batch)
         if (RLGL.ExtSupported.vao) glDeleteVertexArrays(1, &batch.vertexBuffer[i].vaoId);
 
         // Free vertex arrays memory from CPU (RAM)
-        RL_FREE(batch.vertexBuffer[i].vertices);
-        RL_FREE(batch.vertexBuffer[i].texcoords);
-        RL_FREE(batch.vertexBuffer[i].normals);
-        RL_FREE(batch.vertexBuffer[i].colors);
+        if (batch.uploadMode != RL_BATCH_UPLOAD_PERSISTENT)
+        {
+            RL_FREE(batch.vertexBuffer[i].vertices);
+            RL_FREE(batch.vertexBuffer[i].texcoords);
+            RL_FREE(batch.vertexBuffer[i].normals);
+            RL_FREE(batch.vertexBuffer[i].colors);
+        }
         RL_FREE(batch.vertexBuffer[i].indices);
     }
 
@@ -2907,46 +2995,21 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
     // Update batch vertex buffers
     //------------------------------------------------------------------------------------------------------------
     // NOTE: If there is not vertex data, buffers doesn't need to be updated (vertexCount > 0)
-    // TODO: If no data changed on the CPU arrays --> No need to re-update GPU arrays (use a change detector flag?)
-    if (RLGL.State.vertexCounter > 0)
+    // NOTE: Persistent mapped buffers already hold the vertex data, written in place by rlVertex3f()
+    int drawnVertices = RLGL.State.vertexCounter;
+
+    if ((RLGL.State.vertexCounter > 0) && (batch->uploadMode != RL_BATCH_UPLOAD_PERSISTENT))
     {
+        rlVertexBuffer *buffer = &batch->vertexBuffer[batch->currentBuffer];
+
         // Activate elements VAO
-        if (RLGL.ExtSupported.vao) glBindVertexArray(batch->vertexBuffer[batch->currentBuffer].vaoId);
-
-        // Vertex positions buffer
-        glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[0]);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, RLGL.State.vertexCounter*3*sizeof(float), batch->vertexBuffer[batch->currentBuffer].vertices);
-        //glBufferData(GL_ARRAY_BUFFER, sizeof(float)*3*4*batch->vertexBuffer[batch->currentBuffer].elementCount, batch->vertexBuffer[batch->currentBuffer].vertices, GL_DYNAMIC_DRAW);  // Update all buffer
-
-        // Texture coordinates buffer
-        glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[1]);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, RLGL.State.vertexCounter*2*sizeof(float), batch->vertexBuffer[batch->currentBuffer].texcoords);
-        //glBufferData(GL_ARRAY_BUFFER, sizeof(float)*2*4*batch->vertexBuffer[batch->currentBuffer].elementCount, batch->vertexBuffer[batch->currentBuffer].texcoords, GL_DYNAMIC_DRAW); // Update all buffer
-
-        // Normals buffer
-        glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[2]);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, RLGL.State.vertexCounter*3*sizeof(float), batch->vertexBuffer[batch->currentBuffer].normals);
-        //glBufferData(GL_ARRAY_BUFFER, sizeof(float)*3*4*batch->vertexBuffer[batch->currentBuffer].elementCount, batch->vertexBuffer[batch->currentBuffer].normals, GL_DYNAMIC_DRAW); // Update all buffer
-
-        // Colors buffer
-        glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[3]);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, RLGL.State.vertexCounter*4*sizeof(unsigned char), batch->vertexBuffer[batch->currentBuffer].colors);
-        //glBufferData(GL_ARRAY_BUFFER, sizeof(float)*4*4*batch->vertexBuffer[batch->currentBuffer].elementCount, batch->vertexBuffer[batch->currentBuffer].colors, GL_DYNAMIC_DRAW);    // Update all buffer
-
-        // NOTE: glMapBuffer() causes sync issue
-        // If GPU is working with this buffer, glMapBuffer() will wait(stall) until GPU to finish its job
-        // To avoid waiting (idle), you can call first glBufferData() with NULL pointer before glMapBuffer()
-        // If you do that, the previous data in PBO will be discarded and glMapBuffer() returns a new
-        // allocated pointer immediately even if GPU is still working with the previous data
-
-        // Another option: map the buffer object into client's memory
-        // Probably this code could be moved somewhere else...
-        // batch->vertexBuffer[batch->currentBuffer].vertices = (float *)glMapBuffer(GL_ARRAY_BUFFER, GL_READ_WRITE);
-        // if (batch->vertexBuffer[batch->currentBuffer].vertices)
-        // {
-            // Update vertex data
-        // }
-        // glUnmapBuffer(GL_ARRAY_BUFFER);
+        if (RLGL.ExtSupported.vao) glBindVertexArray(buffer->vaoId);
+
+        // Vertex positions, texture coordinates, normals and colors buffers
+        rlUpdateBatchBuffer(buffer->vboId[0], buffer->elementCount*3*4*sizeof(float), RLGL.State.vertexCounter*3*sizeof(float), buffer->vertices, batch->uploadMode);
+        rlUpdateBatchBuffer(buffer->vboId[1], buffer->elementCount*2*4*sizeof(float), RLGL.State.vertexCounter*2*sizeof(float), buffer->texcoords, batch->uploadMode);
+        rlUpdateBatchBuffer(buffer->vboId[2], buffer->elementCount*3*4*sizeof(float), RLGL.State.vertexCounter*3*sizeof(float), buffer->normals, batch->uploadMode);
+        rlUpdateBatchBuffer(buffer->vboId[3], buffer->elementCount*4*4*sizeof(unsigned char), RLGL.State.vertexCounter*4*sizeof(unsigned char), buffer->colors, batch->uploadMode);
 
         // Unbind the current VAO
         if (RLGL.ExtSupported.vao) glBindVertexArray(0);
@@ -3052,26 +3115,31 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
             // NOTE: Batch system accumulates calls by texture0 changes, additional textures are enabled for all the draw calls
             glActiveTexture(GL_TEXTURE0);
 
-            for (int i = 0, vertexOffset = 0; i < batch->drawCounter; i++)
+            if (RLGL.State.drawSorting) rlDrawRenderBatchSorted(batch);
+            else
             {
-                // Bind current draw call texture, activated as GL_TEXTURE0 and Bound to sampler2D texture0 by default
-                glBindTexture(GL_TEXTURE_2D, batch->draws[i].textureId);
-
-                if ((batch->draws[i].mode == RL_LINES) || (batch->draws[i].mode == RL_TRIANGLES)) glDrawArrays(batch->draws[i].mode, vertexOffset, batch->draws[i].vertexCount);
-                else
+                for (int i = 0, vertexOffset = 0; i < batch->drawCounter; i++)
                 {
+                    // Bind current draw call texture, activated as GL_TEXTURE0 and Bound to sampler2D texture0 by default
+                    glBindTexture(GL_TEXTURE_2D, batch->draws[i].textureId);
+                    if (batch->draws[i].vertexCount > 0) RLGL.State.batchFrameDrawCalls++;
+
+                    if ((batch->draws[i].mode == RL_LINES) || (batch->draws[i].mode == RL_TRIANGLES)) glDrawArrays(batch->draws[i].mode, vertexOffset, batch->draws[i].vertexCount);
+                    else
+                    {
     #if defined(GRAPHICS_API_OPENGL_33)
-                    // We need to define the number of indices to be processed: elementCount*6
-                    // NOTE: The final parameter tells the GPU the offset in bytes from the
-                    // start of the index buffer to the location of the first index to process
-                    glDrawElements(GL_TRIANGLES, batch->draws[i].vertexCount/4*6, GL_UNSIGNED_INT, (GLvoid *)(vertexOffset/4*6*sizeof(GLuint)));
+                        // We need to define the number of indices to be processed: elementCount*6
+                        // NOTE: The final parameter tells the GPU the offset in bytes from the
+                        // start of the index buffer to the location of the first index to process
+                        glDrawElements(GL_TRIANGLES, batch->draws[i].vertexCount/4*6, GL_UNSIGNED_INT, (GLvoid *)(vertexOffset/4*6*sizeof(GLuint)));
     #endif
     #if defined(GRAPHICS_API_OPENGL_ES2)
-                    glDrawElements(GL_TRIANGLES, batch->draws[i].vertexCount/4*6, GL_UNSIGNED_SHORT, (GLvoid *)(vertexOffset/4*6*sizeof(GLushort)));
+                        glDrawElements(GL_TRIANGLES, batch->draws[i].vertexCount/4*6, GL_UNSIGNED_SHORT, (GLvoid *)(vertexOffset/4*6*sizeof(GLushort)));
     #endif
-                }
+                    }
 
-                vertexOffset += (batch->draws[i].vertexCount + batch->draws[i].vertexAlignment);
+                    vertexOffset += (batch->draws[i].vertexCount + batch->draws[i].vertexAlignment);
+                }
             }
 
             if (!RLGL.ExtSupported.vao)
@@ -3090,6 +3158,23 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
 
     // Restore viewport to default measures
     if (eyeCount == 2) rlViewport(0, 0, RLGL.State.framebufferWidth, RLGL.State.framebufferHeight);
+
+#if defined(GRAPHICS_API_OPENGL_43)
+    // Fence the buffer, its vertex data can not be overwritten until the GPU is done reading it
+    if ((batch->uploadMode == RL_BATCH_UPLOAD_PERSISTENT) && (drawnVertices > 0))
+    {
+        rlVertexBuffer *buffer = &batch->vertexBuffer[batch->currentBuffer];
+        if (buffer->fence != NULL) glDeleteSync((GLsync)buffer->fence);
+        buffer->fence = (void *)glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+#endif
+
+    // Register default batch frame statistics (used for adaptive sizing)
+    if (batch == &RLGL.defaultBatch)
+    {
+        RLGL.State.batchFrameVertices += drawnVertices;
+        if (drawnVertices > RLGL.State.batchFramePeak) RLGL.State.batchFramePeak = drawnVertices;
+    }
     //------------------------------------------------------------------------------------------------------------
 
     // Reset batch buffers
@@ -3120,8 +3205,15 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
     //------------------------------------------------------------------------------------------------------------
 
     // Change to next buffer in the list (in case of multi-buffering)
-    batch->currentBuffer++;
-    if (batch->currentBuffer >= batch->bufferCount) batch->currentBuffer = 0;
+    // NOTE: Only required if current buffer was used, empty draws (state changes) keep filling it
+    if (drawnVertices > 0)
+    {
+        batch->currentBuffer++;
+        if (batch->currentBuffer >= batch->bufferCount) batch->currentBuffer = 0;
+
+        // Next buffer could still be in use by the GPU if the ring is short
+        rlWaitBatchBuffer(&batch->vertexBuffer[batch->currentBuffer]);
+    }
 #endif
 }
 
@@ -3155,6 +3247,7 @@ bool rlCheckRenderBatchLimit(int vCount)
         (RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].elementCount*4))
     {
         overflow = true;
+        if (RLGL.currentBatch == &RLGL.defaultBatch) RLGL.State.batchFrameOverflows++;
 
         // Store current primitive drawing mode and texture id
         int currentMode = RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].mode;
@@ -3171,6 +3264,205 @@ bool rlCheckRenderBatchLimit(int vCount)
     return overflow;
 }
 
+// Reload default render batch with a ring of numBuffers buffers of bufferElements each
+// NOTE: uploadMode falls back to what the OpenGL context supports (PERSISTENT -> ORPHAN)
+void rlSetRenderBatchConfig(int numBuffers, int bufferElements, int uploadMode)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    if (numBuffers < 1) numBuffers = 1;
+    if (bufferElements < 1) bufferElements = 1;
+    if (bufferElements > RL_MAX_BATCH_BUFFER_ELEMENTS) bufferElements = RL_MAX_BATCH_BUFFER_ELEMENTS;
+
+    RLGL.State.batchUploadMode = uploadMode;
+    rlReloadRenderBatchDefault(numBuffers, bufferElements);
+#endif
+}
+
+// Resize default render batch elements to the vertex count of previous frames
+// NOTE: Batch grows as soon as a frame overflows it and shrinks back after some frames under the limit,
+// never below RL_DEFAULT_BATCH_BUFFER_ELEMENTS, checked on rlRenderBatchFrameEnd()
+void rlSetRenderBatchAdaptive(bool enabled)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    RLGL.State.batchAdaptive = enabled;
+    RLGL.State.batchShrinkFrames = 0;
+#endif
+}
+
+// Mark the end of a frame for render batch statistics and adaptive sizing
+void rlRenderBatchFrameEnd(void)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    if (RLGL.State.batchAdaptive && (RLGL.currentBatch == &RLGL.defaultBatch))
+    {
+        int elements = RLGL.defaultBatch.vertexBuffer[0].elementCount;
+
+        // Elements (quads) required by previous frame vertex count, with some room to grow
+        // NOTE: When the batch overflowed the peak is just the buffer size, all the frame vertex are required
+        int frameVertices = (RLGL.State.batchFrameOverflows > 0)? RLGL.State.batchFrameVertices : RLGL.State.batchFramePeak;
+        int required = frameVertices/4 + frameVertices/16 + 1;
+
+        int target = RL_DEFAULT_BATCH_BUFFER_ELEMENTS;
+        while ((target < required) && (target < RL_MAX_BATCH_BUFFER_ELEMENTS)) target *= 2;
+        if (target > RL_MAX_BATCH_BUFFER_ELEMENTS) target = RL_MAX_BATCH_BUFFER_ELEMENTS;
+
+        if ((RLGL.State.batchFrameOverflows > 0) && (target > elements))
+        {
+            rlReloadRenderBatchDefault(RLGL.defaultBatch.bufferCount, target);
+            RLGL.State.batchShrinkFrames = 0;
+        }
+        else if (target < elements)
+        {
+            // Shrink only after a few seconds of frames fitting, avoid reloading buffers every other frame
+            RLGL.State.batchShrinkFrames++;
+            if (RLGL.State.batchShrinkFrames >= 240)
+            {
+                rlReloadRenderBatchDefault(RLGL.defaultBatch.bufferCount, target);
+                RLGL.State.batchShrinkFrames = 0;
+            }
+        }
+        else RLGL.State.batchShrinkFrames = 0;
+    }
+
+    RLGL.State.batchLastStalls = RLGL.State.batchFrameStalls;
+    RLGL.State.batchLastDrawCalls = RLGL.State.batchFrameDrawCalls;
+    RLGL.State.batchFrameDrawCalls = 0;
+    RLGL.State.batchFrameVertices = 0;
+    RLGL.State.batchFramePeak = 0;
+    RLGL.State.batchFrameOverflows = 0;
+    RLGL.State.batchFrameStalls = 0;
+#endif
+}
+
+// Get default render batch number of buffers
+int rlGetRenderBatchBuffers(void)
+{
+    int count = 0;
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    count = RLGL.defaultBatch.bufferCount;
+#endif
+    return count;
+}
+
+// Get default render batch elements per buffer
+int rlGetRenderBatchElements(void)
+{
+    int elements = 0;
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    if (RLGL.defaultBatch.vertexBuffer != NULL) elements = RLGL.defaultBatch.vertexBuffer[0].elementCount;
+#endif
+    return elements;
+}
+
+// Get default render batch upload mode (after fallback)
+int rlGetRenderBatchUploadMode(void)
+{
+    int mode = RL_BATCH_UPLOAD_SUBDATA;
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    mode = RLGL.defaultBatch.uploadMode;
+#endif
+    return mode;
+}
+
+// Get number of waits on a buffer still in use by the GPU during last frame
+// NOTE: Only persistent mapped buffers can tell, other modes wait inside the driver
+int rlGetRenderBatchStalls(void)
+{
+    int stalls = 0;
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    stalls = RLGL.State.batchLastStalls;
+#endif
+    return stalls;
+}
+
+// Get number of draw calls submitted by render batches during last frame
+int rlGetRenderBatchDrawCalls(void)
+{
+    int drawCalls = 0;
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    drawCalls = RLGL.State.batchLastDrawCalls;
+#endif
+    return drawCalls;
+}
+
+// Enable draw sorting
+// NOTE: Draws in a batch (one per texture or mode change) are reordered on rlDrawRenderBatch() to group
+// the ones sharing texture and mode, a draw only moves past draws its vertex bounds don't overlap,
+// so the result looks the same. Bounds only consider x and y, it's meant for 2D drawing without depth test.
+// Shader, blend mode and matrices changes still draw the batch, they are not deferred
+void rlEnableDrawSorting(void)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    if (RLGL.State.drawSorting) return;
+
+    // Draws already in the batch have no bounds
+    rlDrawRenderBatch(RLGL.currentBatch);
+    RLGL.State.drawSorting = true;
+#endif
+}
+
+// Disable draw sorting
+void rlDisableDrawSorting(void)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    if (!RLGL.State.drawSorting) return;
+
+    rlDrawRenderBatch(RLGL.currentBatch);
+    RLGL.State.drawSorting = false;
+    RLGL.State.drawLayer = 0;
+#endif
+}
+
+// Check if draw sorting is enabled
+bool rlIsDrawSortingEnabled(void)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    return RLGL.State.drawSorting;
+#else
+    return false;
+#endif
+}
+
+// Set layer for following draws, lower layers are drawn first, same layer keeps drawing order
+// NOTE: Only used with draw sorting, call it outside rlBegin()/rlEnd() like rlSetTexture()
+// WARNING: Layers only order draws within a batch, anything drawing the batch (full buffers, shader,
+// blend mode or matrix changes) draws every layer so far, and only within RL_MAX_SORTED_DRAWCALLS draws of each other
+void rlSetDrawLayer(int layer)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    if (!RLGL.State.drawSorting || (RLGL.State.drawLayer == layer)) return;
+
+    RLGL.State.drawLayer = layer;
+
+    // Following vertex go into a new draw, keeping current mode and texture
+    rlDrawCall *draw = &RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1];
+
+    if (draw->vertexCount > 0)
+    {
+        int mode = draw->mode;
+        unsigned int textureId = draw->textureId;
+
+        // Align vertex count for the next draw, same as on rlSetTexture()
+        if (mode == RL_LINES) draw->vertexAlignment = ((draw->vertexCount < 4)? draw->vertexCount : draw->vertexCount%4);
+        else if (mode == RL_TRIANGLES) draw->vertexAlignment = ((draw->vertexCount < 4)? 1 : (4 - (draw->vertexCount%4)));
+        else draw->vertexAlignment = 0;
+
+        if (!rlCheckRenderBatchLimit(draw->vertexAlignment))
+        {
+            RLGL.State.vertexCounter += draw->vertexAlignment;
+            RLGL.currentBatch->drawCounter++;
+        }
+
+        if (RLGL.currentBatch->drawCounter >= RL_DEFAULT_BATCH_DRAWCALLS) rlDrawRenderBatch(RLGL.currentBatch);
+
+        draw = &RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1];
+        draw->mode = mode;
+        draw->textureId = textureId;
+        draw->vertexCount = 0;
+    }
+#endif
+}
+
 // Textures data management
 //-----------------------------------------------------------------------------------------
 // Convert image data to OpenGL texture (returns OpenGL valid Id)
@@ -4993,6 +5285,321 @@ static void rlUnloadShaderDefault(void)
     TRACELOG(RL_LOG_INFO, "SHADER: [ID %i] Default shader unloaded successfully", RLGL.State.defaultShaderId);
 }
 
+// Load a render batch vertex buffer, returns the memory to write vertex data to
+// NOTE: Persistent mapped buffers return the mapped GPU memory, others keep writing to data (RAM)
+static void *rlLoadBatchBuffer(unsigned int *id, int size, void *data, int uploadMode)
+{
+    void *memory = data;
+
+    glGenBuffers(1, id);
+    glBindBuffer(GL_ARRAY_BUFFER, *id);
+
+#if defined(GRAPHICS_API_OPENGL_43)
+    if (uploadMode == RL_BATCH_UPLOAD_PERSISTENT)
+    {
+        // NOTE: Coherent mapping, data written is visible to the GPU on next draw without flushing
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, size, NULL, flags);
+        memory = glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags);
+
+        if (memory != NULL) memset(memory, 0, size);
+        else TRACELOG(RL_LOG_WARNING, "RLGL: [ID %i] Failed to map render batch vertex buffer", *id);
+    }
+    else glBufferData(GL_ARRAY_BUFFER, size, data, GL_DYNAMIC_DRAW);
+#else
+    glBufferData(GL_ARRAY_BUFFER, size, data, GL_DYNAMIC_DRAW);
+#endif
+
+    return memory;
+}
+
+// Load render batch vertex data arrays in RAM (CPU), not used by persistent mapped buffers
+static void rlLoadBatchVertexArrays(rlVertexBuffer *buffer, int bufferElements)
+{
+    buffer->vertices = (float *)RL_MALLOC(bufferElements*3*4*sizeof(float));        // 3 float by vertex, 4 vertex by quad
+    buffer->texcoords = (float *)RL_MALLOC(bufferElements*2*4*sizeof(float));       // 2 float by texcoord, 4 texcoord by quad
+    buffer->normals = (float *)RL_MALLOC(bufferElements*3*4*sizeof(float));        // 3 float by vertex, 4 vertex by quad
+    buffer->colors = (unsigned char *)RL_MALLOC(bufferElements*4*4*sizeof(unsigned char));   // 4 float by color, 4 colors by quad
+
+    for (int j = 0; j < (3*4*bufferElements); j++) buffer->vertices[j] = 0.0f;
+    for (int j = 0; j < (2*4*bufferElements); j++) buffer->texcoords[j] = 0.0f;
+    for (int j = 0; j < (3*4*bufferElements); j++) buffer->normals[j] = 0.0f;
+    for (int j = 0; j < (4*4*bufferElements); j++) buffer->colors[j] = 0;
+}
+
+// Load render batch vertex buffers and enable their attributes on the bound VAO
+// NOTE: Returns false if persistent mapping failed for any of them
+static bool rlLoadBatchVertexBuffers(rlVertexBuffer *buffer, int bufferElements, int uploadMode)
+{
+    // Vertex position buffer (shader-location = 0)
+    buffer->vertices = (float *)rlLoadBatchBuffer(&buffer->vboId[0], bufferElements*3*4*sizeof(float), buffer->vertices, uploadMode);
+    glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_POSITION]);
+    glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_POSITION], 3, GL_FLOAT, 0, 0, 0);
+
+    // Vertex texcoord buffer (shader-location = 1)
+    buffer->texcoords = (float *)rlLoadBatchBuffer(&buffer->vboId[1], bufferElements*2*4*sizeof(float), buffer->texcoords, uploadMode);
+    glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_TEXCOORD01]);
+    glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_TEXCOORD01], 2, GL_FLOAT, 0, 0, 0);
+
+    // Vertex normal buffer (shader-location = 2)
+    buffer->normals = (float *)rlLoadBatchBuffer(&buffer->vboId[2], bufferElements*3*4*sizeof(float), buffer->normals, uploadMode);
+    glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_NORMAL]);
+    glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_NORMAL], 3, GL_FLOAT, 0, 0, 0);
+
+    // Vertex color buffer (shader-location = 3)
+    buffer->colors = (unsigned char *)rlLoadBatchBuffer(&buffer->vboId[3], bufferElements*4*4*sizeof(unsigned char), buffer->colors, uploadMode);
+    glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_COLOR]);
+    glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_COLOR], 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, 0);
+
+    return ((buffer->vertices != NULL) && (buffer->texcoords != NULL) && (buffer->normals != NULL) && (buffer->colors != NULL));
+}
+
+// Unmap and delete render batch vertex buffers, index buffer is kept
+static void rlUnloadBatchVertexBuffers(rlVertexBuffer *buffer)
+{
+#if defined(GRAPHICS_API_OPENGL_43)
+    void *mapped[4] = { buffer->vertices, buffer->texcoords, buffer->normals, buffer->colors };
+
+    for (int i = 0; i < 4; i++)
+    {
+        if (mapped[i] != NULL)
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, buffer->vboId[i]);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        }
+    }
+#endif
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glDeleteBuffers(4, buffer->vboId);
+
+    buffer->vertices = NULL;
+    buffer->texcoords = NULL;
+    buffer->normals = NULL;
+    buffer->colors = NULL;
+}
+
+// Update a render batch vertex buffer with dataSize bytes of vertex data
+// NOTE: Orphaning allocates new storage for the buffer (glBufferData() with NULL), so the driver doesn't need to wait
+// for the GPU to finish drawing the previous data before glBufferSubData() overwrites it
+static void rlUpdateBatchBuffer(unsigned int id, int bufferSize, int dataSize, const void *data, int uploadMode)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, id);
+    if (uploadMode == RL_BATCH_UPLOAD_ORPHAN) glBufferData(GL_ARRAY_BUFFER, bufferSize, NULL, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, dataSize, data);
+}
+
+// Wait for the GPU to finish reading a persistent mapped render batch buffer before writing to it again
+static void rlWaitBatchBuffer(rlVertexBuffer *buffer)
+{
+#if defined(GRAPHICS_API_OPENGL_43)
+    if (buffer->fence == NULL) return;
+
+    GLsync fence = (GLsync)buffer->fence;
+    GLenum result = glClientWaitSync(fence, 0, 0);
+
+    if (result == GL_TIMEOUT_EXPIRED)
+    {
+        // NOTE: Commands are flushed so the fence is sure to signal, waiting 1 ms at a time
+        RLGL.State.batchFrameStalls++;
+        while (result == GL_TIMEOUT_EXPIRED) result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+    }
+
+    glDeleteSync(fence);
+    buffer->fence = NULL;
+#endif
+}
+
+// Check if draw a has to be drawn before draw b: lower layer first, same layer in submission order
+static bool rlDrawGoesFirst(const rlDrawCall *draws, int a, int b)
+{
+    if (draws[a].layer != draws[b].layer) return (draws[a].layer < draws[b].layer);
+    return (a < b);
+}
+
+// Check if two draws vertex bounds overlap
+// NOTE: Bounds are grown by margin so lines and touching edges keep their order
+static bool rlDrawsOverlap(const rlDrawCall *a, const rlDrawCall *b, float margin)
+{
+    return ((a->minx - margin) <= b->maxx) && ((b->minx - margin) <= a->maxx) &&
+           ((a->miny - margin) <= b->maxy) && ((b->miny - margin) <= a->maxy);
+}
+
+// Get how many vertex units one pixel covers with the current modelview
+// NOTE: Draw bounds are in vertex space, before the modelview, a Camera2D zoom below 1 or rlScalef() makes
+// a one pixel line cover more than one unit. Projection is assumed to map one unit to one pixel (rlOrtho() over the screen)
+static float rlGetDrawOverlapMargin(void)
+{
+    Matrix mv = RLGL.State.modelview;
+    float scaleX = sqrtf(mv.m0*mv.m0 + mv.m1*mv.m1);
+    float scaleY = sqrtf(mv.m4*mv.m4 + mv.m5*mv.m5);
+    float scale = (scaleX < scaleY)? scaleX : scaleY;
+
+    return (scale > 0.0f)? 1.0f/scale : 1.0f;
+}
+
+// Draw render batch draw calls grouped by texture and mode
+// NOTE: Draws are reordered in windows of RL_MAX_SORTED_DRAWCALLS draws, one window after another, so the pairwise
+// overlap checks stay bounded. Within a window draws are scheduled one at a time, a draw is ready once every
+// overlapping draw that goes before it has been drawn, ready draws sharing texture and mode with the last one are
+// preferred. Every run of draws sharing texture and mode is submitted with a single texture bind and draw call (glMultiDraw*())
+static void rlDrawRenderBatchSorted(rlRenderBatch *batch)
+{
+    // Scratch arrays for one window, static to keep them off the stack
+    static int offsets[RL_MAX_SORTED_DRAWCALLS] = { 0 };    // First vertex of every draw
+    static int waiting[RL_MAX_SORTED_DRAWCALLS] = { 0 };    // Overlapping draws still to be drawn before every draw
+    static bool drawn[RL_MAX_SORTED_DRAWCALLS] = { 0 };
+    static int order[RL_MAX_SORTED_DRAWCALLS] = { 0 };
+#if defined(GRAPHICS_API_OPENGL_33)
+    static GLsizei counts[RL_MAX_SORTED_DRAWCALLS] = { 0 };
+    static GLint firsts[RL_MAX_SORTED_DRAWCALLS] = { 0 };
+    static const void *indices[RL_MAX_SORTED_DRAWCALLS] = { 0 };
+#endif
+    unsigned int boundTextureId = 0;
+    int vertexOffset = 0;
+    float margin = rlGetDrawOverlapMargin();
+
+    for (int window = 0; window < batch->drawCounter; window += RL_MAX_SORTED_DRAWCALLS)
+    {
+        const rlDrawCall *draws = &batch->draws[window];
+        int drawCount = batch->drawCounter - window;
+        if (drawCount > RL_MAX_SORTED_DRAWCALLS) drawCount = RL_MAX_SORTED_DRAWCALLS;
+        int orderCount = 0;
+
+        for (int i = 0; i < drawCount; i++)
+        {
+            offsets[i] = vertexOffset;
+            vertexOffset += (draws[i].vertexCount + draws[i].vertexAlignment);
+            waiting[i] = 0;
+            drawn[i] = (draws[i].vertexCount == 0);     // Nothing to draw
+        }
+
+        for (int i = 0; i < drawCount; i++)
+        {
+            for (int j = i + 1; j < drawCount; j++)
+            {
+                if (drawn[i] || drawn[j] || !rlDrawsOverlap(&draws[i], &draws[j], margin)) continue;
+
+                if (rlDrawGoesFirst(draws, i, j)) waiting[j]++;
+                else waiting[i]++;
+            }
+        }
+
+        // Schedule draws
+        for (int last = -1;;)
+        {
+            int next = -1;
+            bool nextGroups = false;
+
+            for (int i = 0; i < drawCount; i++)
+            {
+                if (drawn[i] || (waiting[i] > 0)) continue;
+
+                bool groups = (last >= 0) && (draws[i].textureId == draws[last].textureId) && (draws[i].mode == draws[last].mode);
+
+                if ((next < 0) || (groups && !nextGroups) || ((groups == nextGroups) && rlDrawGoesFirst(draws, i, next)))
+                {
+                    next = i;
+                    nextGroups = groups;
+                }
+            }
+
+            if (next < 0) break;
+
+            drawn[next] = true;
+            order[orderCount++] = next;
+            last = next;
+
+            for (int j = 0; j < drawCount; j++)
+            {
+                if (!drawn[j] && rlDrawGoesFirst(draws, next, j) && rlDrawsOverlap(&draws[next], &draws[j], margin)) waiting[j]--;
+            }
+        }
+
+        // Submit draws, one draw call for every run sharing texture and mode
+        for (int k = 0; k < orderCount;)
+        {
+            const rlDrawCall *draw = &draws[order[k]];
+
+            int runCount = 1;
+            while ((k + runCount < orderCount) && (draws[order[k + runCount]].textureId == draw->textureId) &&
+                   (draws[order[k + runCount]].mode == draw->mode)) runCount++;
+
+            if (((window == 0) && (k == 0)) || (draw->textureId != boundTextureId)) glBindTexture(GL_TEXTURE_2D, draw->textureId);
+            boundTextureId = draw->textureId;
+
+#if defined(GRAPHICS_API_OPENGL_33)
+            // Vertex ranges, merging the ones following each other in the buffer
+            int rangeCount = 0;
+
+            for (int r = 0; r < runCount; r++)
+            {
+                int index = order[k + r];
+
+                if ((rangeCount > 0) && ((firsts[rangeCount - 1] + counts[rangeCount - 1]) == offsets[index])) counts[rangeCount - 1] += draws[index].vertexCount;
+                else
+                {
+                    firsts[rangeCount] = offsets[index];
+                    counts[rangeCount] = draws[index].vertexCount;
+                    rangeCount++;
+                }
+            }
+
+            if ((draw->mode == RL_LINES) || (draw->mode == RL_TRIANGLES))
+            {
+                if (rangeCount == 1) glDrawArrays(draw->mode, firsts[0], counts[0]);
+                else glMultiDrawArrays(draw->mode, firsts, counts, rangeCount);
+            }
+            else
+            {
+                // Quads are drawn indexed, 6 indices for every 4 vertex
+                for (int r = 0; r < rangeCount; r++)
+                {
+                    indices[r] = (const void *)(firsts[r]/4*6*sizeof(GLuint));
+                    counts[r] = counts[r]/4*6;
+                }
+
+                if (rangeCount == 1) glDrawElements(GL_TRIANGLES, counts[0], GL_UNSIGNED_INT, indices[0]);
+                else glMultiDrawElements(GL_TRIANGLES, counts, GL_UNSIGNED_INT, indices, rangeCount);
+            }
+
+            RLGL.State.batchFrameDrawCalls++;
+#endif
+#if defined(GRAPHICS_API_OPENGL_ES2)
+            // NOTE: No multi-draw on OpenGL ES 2.0, draws are submitted one by one but still share texture binds
+            for (int r = 0; r < runCount; r++)
+            {
+                int index = order[k + r];
+
+                if ((draw->mode == RL_LINES) || (draw->mode == RL_TRIANGLES)) glDrawArrays(draw->mode, offsets[index], draws[index].vertexCount);
+                else glDrawElements(GL_TRIANGLES, draws[index].vertexCount/4*6, GL_UNSIGNED_SHORT, (GLvoid *)(offsets[index]/4*6*sizeof(GLushort)));
+
+                RLGL.State.batchFrameDrawCalls++;
+            }
+#endif
+
+            k += runCount;
+        }
+    }
+}
+
+// Reload default render batch with a new size, drawing whatever it holds first
+// NOTE: Default batch is loaded with default shader locations, same as on rlglInit()
+static void rlReloadRenderBatchDefault(int numBuffers, int bufferElements)
+{
+    rlDrawRenderBatchActive();
+    rlUnloadRenderBatch(RLGL.defaultBatch);
+
+    int *currentShaderLocs = RLGL.State.currentShaderLocs;
+    RLGL.State.currentShaderLocs = RLGL.State.defaultShaderLocs;
+    RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_NORMAL] = RL_DEFAULT_SHADER_ATTRIB_LOCATION_NORMAL;
+    RLGL.defaultBatch = rlLoadRenderBatch(numBuffers, bufferElements);
+    RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_NORMAL] = -1;
+    RLGL.State.currentShaderLocs = currentShaderLocs;
+
+    TRACELOG(RL_LOG_INFO, "RLGL: Default render batch reloaded: %i buffers, %i elements", numBuffers, bufferElements);
+}
+
 #if defined(RLGL_SHOW_GL_DETAILS_INFO)
 // Get compressed format official GL identifier name
 static const char *rlGetCompressedFormatName(int format)